@@ -0,0 +1,84 @@
+#include "anagram_index.h"
+
+#include <algorithm>
+
+#include "scrabble/dictionary/dawg.h"
+
+using namespace scrabble;
+
+void AnagramIndex::Build(const Dictionary &dictionary) {
+    std::vector<std::pair<std::string, std::string> > signed_words;
+    signed_words.reserve(dictionary.WordCount());
+    dictionary.ForEachWord([&signed_words](const std::string_view word) {
+        std::string signature(word);
+        std::sort(signature.begin(), signature.end());
+        signed_words.emplace_back(std::move(signature), std::string(word));
+    });
+    Finish(signed_words);
+}
+
+void AnagramIndex::Build(const std::vector<std::string> &words) {
+    std::vector<std::pair<std::string, std::string> > signed_words;
+    signed_words.reserve(words.size());
+    for (const auto &word: words) {
+        std::string signature = word;
+        std::sort(signature.begin(), signature.end());
+        signed_words.emplace_back(std::move(signature), word);
+    }
+    Finish(signed_words);
+}
+
+void AnagramIndex::Finish(std::vector<std::pair<std::string, std::string> > &signed_words) {
+    std::sort(signed_words.begin(), signed_words.end(), [](const auto &a, const auto &b) {
+        if (a.first.size() != b.first.size()) return a.first.size() < b.first.size();
+        return a < b;
+    });
+    signed_words.erase(std::unique(signed_words.begin(), signed_words.end()), signed_words.end());
+
+    classes_.clear();
+    masks_.clear();
+    word_chars_.clear();
+    word_offsets_.clear();
+    length_starts_.clear();
+
+    size_t total_chars = 0;
+    for (const auto &[signature, word]: signed_words) total_chars += word.size();
+    word_chars_.reserve(total_chars);
+    word_offsets_.reserve(signed_words.size() + 1);
+
+    for (size_t i = 0; i < signed_words.size(); i++) {
+        const auto &[signature, word] = signed_words[i];
+        if (i == 0 || signature != signed_words[i - 1].first) {
+            const auto letters = LetterHistogram::FromWord(signature);
+            classes_.push_back({
+                letters,
+                letters.Mask(),
+                static_cast<std::uint32_t>(signature.size()),
+                static_cast<std::uint32_t>(word_offsets_.size()),
+                0
+            });
+            masks_.push_back(letters.Mask());
+        }
+        classes_.back().word_count++;
+        word_offsets_.push_back(static_cast<std::uint32_t>(word_chars_.size()));
+        word_chars_ += word;
+    }
+    word_offsets_.push_back(static_cast<std::uint32_t>(word_chars_.size()));
+
+    const std::uint32_t max_length = classes_.empty() ? 0 : classes_.back().length;
+    for (std::uint32_t n = 0; n <= max_length + 1; n++) {
+        const auto it = std::lower_bound(classes_.begin(), classes_.end(), n, [](const Class &c, const std::uint32_t length) {
+            return c.length < length;
+        });
+        length_starts_.push_back(static_cast<std::uint32_t>(it - classes_.begin()));
+    }
+}
+
+std::string_view AnagramIndex::Word(const std::uint32_t index) const {
+    return std::string_view(word_chars_).substr(word_offsets_[index], word_offsets_[index + 1] - word_offsets_[index]);
+}
+
+size_t AnagramIndex::FirstClassOfLength(const std::uint32_t length) const {
+    if (length >= length_starts_.size()) return classes_.size();
+    return length_starts_[length];
+}
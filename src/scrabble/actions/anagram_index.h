@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "letter_histogram.h"
+
+namespace scrabble {
+    class Dictionary;
+
+    /**
+     * Dictionary words grouped by sorted-letter signature ("STAR", "RATS", "TSAR" -> "ARST").
+     *
+     * Classes are ordered by length, so a search can stop as soon as a class is longer than the
+     * letters available, and each class carries its histogram and mask so it can be accepted or
+     * rejected without looking at its words.
+     */
+    class AnagramIndex {
+    public:
+        struct Class {
+            LetterHistogram letters;
+            LetterMask mask;
+            std::uint32_t length;
+            std::uint32_t first_word; // Index of the first word of this class, see Word()
+            std::uint32_t word_count;
+        };
+
+        void Build(const Dictionary &dictionary);
+
+        /**
+         * Words must already be upper-case A-Z.
+         */
+        void Build(const std::vector<std::string> &words);
+
+        [[nodiscard]] const std::vector<Class> &Classes() const { return classes_; }
+
+        /**
+         * Masks()[i] == Classes()[i].mask, packed densely for the prefilter scan.
+         */
+        [[nodiscard]] const std::vector<LetterMask> &Masks() const { return masks_; }
+
+        [[nodiscard]] std::string_view Word(std::uint32_t index) const;
+
+        [[nodiscard]] size_t WordCount() const { return word_offsets_.empty() ? 0 : word_offsets_.size() - 1; }
+
+        /**
+         * Index of the first class with at least this many letters.
+         */
+        [[nodiscard]] size_t FirstClassOfLength(std::uint32_t length) const;
+
+    private:
+        void Finish(std::vector<std::pair<std::string, std::string> > &signed_words);
+
+        std::vector<Class> classes_;
+
+        std::vector<LetterMask> masks_;
+
+        std::string word_chars_; // All words back to back, in class order
+
+        std::vector<std::uint32_t> word_offsets_; // word i is word_chars_[offsets[i], offsets[i + 1])
+
+        std::vector<std::uint32_t> length_starts_; // length_starts_[n] is the first class with length >= n
+    };
+}
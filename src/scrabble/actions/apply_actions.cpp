@@ -0,0 +1,100 @@
+#include "apply_actions.h"
+
+#include <algorithm>
+
+#include "legal_actions.h"
+#include "tile_bag.h"
+#include "scrabble/context/types.h"
+
+using namespace scrabble;
+
+GameState scrabble::new_game_state(std::mt19937 &rng, const int players, const int word_minimum_size,
+                                   const std::string &dictionary) {
+    GameState game{};
+    game.wordMinimumSize = word_minimum_size;
+    game.playerCount = players;
+    game.dictionary = dictionary;
+    game.playerWords.resize(static_cast<size_t>(std::max(players, 0)));
+
+    std::string letters;
+    letters.reserve(TILE_TOTAL);
+    for (int letter = 0; letter < LETTER_COUNT; letter++) {
+        letters.append(static_cast<size_t>(TILE_DISTRIBUTION[letter]), static_cast<char>('A' + letter));
+    }
+    std::shuffle(letters.begin(), letters.end(), rng);
+
+    game.tiles.reserve(letters.size());
+    for (size_t i = 0; i < letters.size(); i++) {
+        game.tiles.push_back(TileProps{std::string(1, letters[i]), "t" + std::to_string(i), false});
+    }
+    game.tileCount = static_cast<int>(game.tiles.size());
+    return game;
+}
+
+int scrabble::next_face_down(const GameState &game) {
+    for (size_t i = 0; i < game.tiles.size(); i++) {
+        if (!game.tiles[i].faceUp) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool scrabble::apply_flip(GameState &game, const std::string &tile_id) {
+    for (auto &tile: game.tiles) {
+        if (tile.id != tile_id) continue;
+        if (tile.faceUp) return false;
+        tile.faceUp = true;
+        return true;
+    }
+    return false;
+}
+
+bool scrabble::apply_claim(GameState &game, const GameStateUpdate &claim, const std::string &new_word_id) {
+    const auto &word = claim.claimWord;
+    if (claim.actingPlayer < 0 || claim.actingPlayer >= static_cast<int>(game.playerWords.size())) return false;
+    if (static_cast<int>(word.size()) < game.wordMinimumSize) return false;
+    if (!std::all_of(word.begin(), word.end(), [](const char c) { return letter_index(c) >= 0; })) return false;
+
+    const auto letters = LetterHistogram::FromWord(word);
+    const auto pool = public_histogram(game);
+
+    std::vector<Word> *stolen_from = nullptr;
+    size_t stolen_index = 0;
+    LetterHistogram needed = letters;
+    if (!claim.stolenWordId.empty()) {
+        // The server sends stolenPlayer, but a missing one shouldn't make the word impossible to find
+        for (int player = 0; player < static_cast<int>(game.playerWords.size()) && !stolen_from; player++) {
+            if (claim.stolenPlayer && *claim.stolenPlayer != player) continue;
+            auto &words = game.playerWords[static_cast<size_t>(player)];
+            for (size_t i = 0; i < words.size(); i++) {
+                if (words[i].id == claim.stolenWordId) {
+                    stolen_from = &words;
+                    stolen_index = i;
+                    break;
+                }
+            }
+        }
+        if (!stolen_from) return false;
+        const auto &stolen = (*stolen_from)[stolen_index];
+        if (!can_steal_word(word, letters, stolen, pool)) return false;
+        needed = letters.SaturatingSubtract(LetterHistogram::FromWord(stolen.history.front()));
+    } else if (!letters.IsSubsetOf(pool)) {
+        return false;
+    }
+
+    std::erase_if(game.tiles, [&needed](const TileProps &tile) {
+        if (!tile.faceUp || tile.letter.empty() || needed.Get(tile.letter.front()) == 0) return false;
+        needed.Remove(tile.letter.front());
+        return true;
+    });
+
+    auto &claimed = game.playerWords[static_cast<size_t>(claim.actingPlayer)];
+    if (stolen_from) {
+        auto moved = std::move((*stolen_from)[stolen_index]);
+        stolen_from->erase(stolen_from->begin() + static_cast<std::ptrdiff_t>(stolen_index));
+        moved.history.insert(moved.history.begin(), word);
+        claimed.push_back(std::move(moved));
+    } else {
+        claimed.push_back(Word{{word}, new_word_id});
+    }
+    return true;
+}
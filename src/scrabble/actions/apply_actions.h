@@ -0,0 +1,32 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+namespace scrabble {
+    struct GameState;
+    struct GameStateUpdate;
+
+    /**
+     * A game before the first flip: the full tile bag face down in random order, no words.
+     */
+    GameState new_game_state(std::mt19937 &rng, int players, int word_minimum_size, const std::string &dictionary);
+
+    /**
+     * Index of the first face-down tile, or -1 once every tile has been flipped.
+     */
+    int next_face_down(const GameState &game);
+
+    /**
+     * Turns tile_id face up. False if there is no such tile or it is already face up.
+     */
+    bool apply_flip(GameState &game, const std::string &tile_id);
+
+    /**
+     * Applies a CLAIM: the tiles it needs leave the pool, and the word (new, or the stolen one with
+     * the new form at the front of its history) goes to claim.actingPlayer. A pool claim gets
+     * new_word_id; a stolen word keeps its id. Returns false and leaves game untouched if the
+     * claim isn't legal under the same rules as can_steal_word.
+     */
+    bool apply_claim(GameState &game, const GameStateUpdate &claim, const std::string &new_word_id);
+}
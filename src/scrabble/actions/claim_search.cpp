@@ -0,0 +1,129 @@
+#include "claim_search.h"
+
+#include <atomic>
+
+#include "anagram_index.h"
+#include "scrabble/context/types.h"
+#include "util/thread_pool/work_stealing_pool.h"
+
+using namespace scrabble;
+
+namespace {
+    // Small enough that the pool target splits across every worker, large enough that a task
+    // costs far more than taking it from a deque
+    constexpr size_t SLICE_CLASSES = 8192;
+}
+
+struct ClaimSearch::Job {
+    std::shared_ptr<const GameState> game;
+    std::shared_ptr<const AnagramIndex> index;
+    std::shared_ptr<Mailbox> mailbox;
+    SolverBoard board;
+    CancelToken cancel;
+    unsigned generation{0};
+    std::chrono::steady_clock::time_point start;
+    std::vector<std::vector<Claim> > per_worker; // Scratch, indexed by pool worker, no locking
+    std::atomic<size_t> remaining{0};
+    std::atomic<bool> complete{true};
+
+    void Finish() {
+        if (cancel.Cancelled()) return;
+        ClaimSearchResult result;
+        size_t total = 0;
+        for (const auto &claims: per_worker) total += claims.size();
+        result.claims.reserve(total);
+        for (auto &claims: per_worker) {
+            result.claims.insert(result.claims.end(), claims.begin(), claims.end());
+        }
+        rank_claims(result.claims);
+        result.game = game;
+        result.index = index;
+        result.complete = complete.load(std::memory_order_acquire);
+        result.generation = generation;
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard lock(mailbox->mutex);
+        // A newer search may have started (and even finished) while we were merging
+        if (mailbox->running_generation != generation) return;
+        mailbox->running_generation = 0;
+        mailbox->result = std::move(result);
+    }
+};
+
+ClaimSearch::ClaimSearch(WorkStealingPool &pool) : pool_(pool), mailbox_(std::make_shared<Mailbox>()) {
+}
+
+ClaimSearch::~ClaimSearch() {
+    Cancel();
+}
+
+void ClaimSearch::Start(const GameState &game, std::shared_ptr<const AnagramIndex> index,
+                        const std::chrono::milliseconds budget) {
+    Cancel();
+    if (!index) return;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto job = std::make_shared<Job>();
+    job->game = std::make_shared<const GameState>(game);
+    job->index = std::move(index);
+    job->mailbox = mailbox_;
+    job->cancel = CancelToken(start + budget);
+    job->generation = ++generation_;
+    job->start = start;
+    job->per_worker.resize(pool_.ThreadCount());
+    build_solver_board(*job->game, job->board);
+
+    std::vector<WorkStealingPool::Task> tasks;
+    for (size_t t = 0; t < job->board.targets.size(); t++) {
+        const auto [begin, end] = target_class_range(*job->index, job->board, job->board.targets[t]);
+        for (size_t slice = begin; slice < end; slice += SLICE_CLASSES) {
+            const size_t slice_end = std::min(end, slice + SLICE_CLASSES);
+            tasks.emplace_back([job, t, slice, slice_end](const size_t worker) {
+                const auto &target = job->board.targets[t];
+                if (!solve_target_slice(*job->index, target, slice, slice_end, job->per_worker[worker], &job->cancel)) {
+                    job->complete.store(false, std::memory_order_release);
+                }
+                if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    job->Finish();
+                }
+            });
+        }
+    }
+
+    cancel_ = job->cancel;
+    {
+        std::lock_guard lock(mailbox_->mutex);
+        mailbox_->running_generation = job->generation;
+    }
+    if (tasks.empty()) {
+        job->Finish();
+        return;
+    }
+    job->remaining.store(tasks.size(), std::memory_order_release);
+    pool_.SubmitBatch(tasks);
+}
+
+void ClaimSearch::Cancel() {
+    if (!cancel_.has_value()) return;
+    std::lock_guard lock(mailbox_->mutex);
+    if (mailbox_->running_generation != 0) {
+        cancelled_count_++;
+        mailbox_->running_generation = 0;
+    }
+    mailbox_->result.reset();
+    cancel_->Cancel();
+    cancel_.reset();
+}
+
+bool ClaimSearch::Running() const {
+    std::lock_guard lock(mailbox_->mutex);
+    return mailbox_->running_generation != 0;
+}
+
+bool ClaimSearch::TakeResult(ClaimSearchResult &out) {
+    std::lock_guard lock(mailbox_->mutex);
+    if (!mailbox_->result.has_value()) return false;
+    out = std::move(*mailbox_->result);
+    mailbox_->result.reset();
+    return true;
+}
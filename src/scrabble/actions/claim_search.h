@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "solver.h"
+#include "util/thread_pool/cancel_token.h"
+
+class WorkStealingPool;
+
+namespace scrabble {
+    struct GameState;
+    class AnagramIndex;
+
+    /**
+     * Result of one background search. Claims point into game and index, which it keeps alive.
+     */
+    struct ClaimSearchResult {
+        std::shared_ptr<const GameState> game;
+        std::shared_ptr<const AnagramIndex> index;
+        std::vector<Claim> claims; // Ranked, see rank_claims
+        bool complete{false}; // False if the deadline cut it short
+        double elapsed_ms{0};
+        unsigned generation{0};
+    };
+
+    /**
+     * Runs solve_claims on a WorkStealingPool, one task per slice of each target's class range,
+     * without blocking the caller. Starting a new search cancels the previous one; its tasks
+     * notice within a few thousand classes and their results are dropped.
+     */
+    class ClaimSearch {
+    public:
+        explicit ClaimSearch(WorkStealingPool &pool);
+
+        ClaimSearch(const ClaimSearch &) = delete;
+
+        ClaimSearch &operator=(const ClaimSearch &) = delete;
+
+        ~ClaimSearch();
+
+        /**
+         * Snapshots game and starts searching it. A search still running past budget publishes
+         * what it found so far with complete = false.
+         */
+        void Start(const GameState &game, std::shared_ptr<const AnagramIndex> index,
+                   std::chrono::milliseconds budget);
+
+        /**
+         * Abandons the running search, if any, and drops a finished result nobody took yet.
+         */
+        void Cancel();
+
+        [[nodiscard]] bool Running() const;
+
+        /**
+         * Moves out the newest finished search, once. Returns false if none finished since the last call.
+         */
+        bool TakeResult(ClaimSearchResult &out);
+
+        [[nodiscard]] unsigned CancelledCount() const { return cancelled_count_; }
+
+    private:
+        struct Job;
+
+        struct Mailbox {
+            std::mutex mutex;
+            std::optional<ClaimSearchResult> result;
+            unsigned running_generation{0}; // Generation that hasn't reported yet, 0 if none
+        };
+
+        WorkStealingPool &pool_;
+
+        std::shared_ptr<Mailbox> mailbox_; // Shared with in-flight tasks, which may outlive us
+
+        std::optional<CancelToken> cancel_;
+
+        unsigned generation_{0};
+
+        unsigned cancelled_count_{0};
+    };
+}
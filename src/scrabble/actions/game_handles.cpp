@@ -0,0 +1,59 @@
+#include "game_handles.h"
+
+#include <algorithm>
+
+#include "scrabble/context/types.h"
+
+using namespace scrabble;
+
+int IdInterner::Intern(const std::string_view id) {
+    if (const auto it = handles_.find(id); it != handles_.end()) return it->second;
+    const int handle = static_cast<int>(ids_.size());
+    ids_.emplace_back(id);
+    handles_.emplace(ids_.back(), handle);
+    return handle;
+}
+
+int IdInterner::Find(const std::string_view id) const {
+    const auto it = handles_.find(id);
+    return it == handles_.end() ? NO_HANDLE : it->second;
+}
+
+void IdInterner::Clear() {
+    handles_.clear();
+    ids_.clear();
+}
+
+void scrabble::intern_handles(GameState &game, GameInterner &interner) {
+    for (auto &tile: game.tiles) {
+        tile.handle = interner.tiles.Intern(tile.id);
+    }
+    for (auto &player_words: game.playerWords) {
+        for (auto &word: player_words) {
+            word.handle = interner.words.Intern(word.id);
+        }
+    }
+}
+
+void scrabble::intern_handles(GameStateUpdate &update, GameInterner &interner) {
+    update.flippedTileHandle = update.flippedTileId.empty() ? NO_HANDLE : interner.tiles.Intern(update.flippedTileId);
+}
+
+void scrabble::intern_handles(MultiplayerGame &game, GameInterner &interner) {
+    intern_handles(game.state, interner);
+    if (game.lastAction.has_value()) {
+        intern_handles(*game.lastAction, interner);
+    }
+}
+
+void HandleTable::Rebuild(const GameState &game, const GameInterner &interner) {
+    tile_index_.assign(interner.tiles.Size(), -1);
+    for (int i = 0; i < static_cast<int>(game.tiles.size()); i++) {
+        const int handle = game.tiles[i].handle;
+        if (handle >= 0 && handle < static_cast<int>(tile_index_.size())) tile_index_[handle] = i;
+    }
+}
+
+void HandleTable::Clear() {
+    tile_index_.clear();
+}
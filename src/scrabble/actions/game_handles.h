@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace scrabble {
+    struct GameState;
+    struct GameStateUpdate;
+    struct MultiplayerGame;
+
+    constexpr int NO_HANDLE = -1;
+
+    /**
+     * Maps string ids to dense integers 0, 1, 2... in first-seen order. Ids are stable for a whole
+     * game, so one interner lives as long as the game does and handles compare across snapshots.
+     */
+    class IdInterner {
+    public:
+        int Intern(std::string_view id);
+
+        /**
+         * NO_HANDLE if the id was never interned.
+         */
+        [[nodiscard]] int Find(std::string_view id) const;
+
+        [[nodiscard]] const std::string &Id(int handle) const { return ids_[handle]; }
+
+        [[nodiscard]] size_t Size() const { return ids_.size(); }
+
+        void Clear();
+
+    private:
+        struct Hash {
+            using is_transparent = void;
+
+            size_t operator()(const std::string_view id) const { return std::hash<std::string_view>{}(id); }
+        };
+
+        std::unordered_map<std::string, int, Hash, std::equal_to<> > handles_;
+
+        std::vector<std::string> ids_;
+    };
+
+    /**
+     * Tile ids and word ids are separate namespaces, so they get separate handle spaces.
+     */
+    struct GameInterner {
+        IdInterner tiles;
+        IdInterner words;
+
+        void Clear() {
+            tiles.Clear();
+            words.Clear();
+        }
+    };
+
+    /**
+     * Fills in the handle fields from the string ids. Call once per message, on the thread that
+     * owns the interner, before anything looks the handles up.
+     */
+    void intern_handles(GameState &game, GameInterner &interner);
+
+    void intern_handles(GameStateUpdate &update, GameInterner &interner);
+
+    void intern_handles(MultiplayerGame &game, GameInterner &interner);
+
+    /**
+     * Where each tile handle sits in one snapshot. Rebuilt per snapshot, in one pass, without
+     * allocating once it has grown to the interner's size.
+     */
+    class HandleTable {
+    public:
+        /**
+         * game must already be interned with interner.
+         */
+        void Rebuild(const GameState &game, const GameInterner &interner);
+
+        void Clear();
+
+        /**
+         * Index into GameState::tiles, or -1 if the tile isn't on the table in this snapshot.
+         */
+        [[nodiscard]] int TileIndex(const int handle) const {
+            return handle >= 0 && handle < static_cast<int>(tile_index_.size()) ? tile_index_[handle] : -1;
+        }
+
+    private:
+        std::vector<int> tile_index_;
+    };
+}
@@ -1,80 +1,48 @@
 #include "legal_actions.h"
-#include "legal_actions.h"
-#include "legal_actions.h"
 
 #include "scrabble/context/types.h"
 
 using namespace scrabble;
 
-bool WordCounter::ContainsKey(const char c) const {
-    return map_[c - 65] > 0;
-}
-
-void WordCounter::InsertOrIncrement(const char c) {
-    map_[c - 65]++;
-}
-
-int WordCounter::Get(const char c) const {
-    return map_[c - 65];
-}
-
-std::vector<char> WordCounter::Keys() const {
-    auto result = std::vector<char>();
-    for (char i = 'A'; i <= 'Z'; i++) {
-        if (ContainsKey(i)) result.push_back(i);
+LetterHistogram scrabble::public_histogram(const GameState &game) {
+    LetterHistogram result;
+    for (const auto &t: game.tiles) {
+        if (!t.faceUp || t.letter.empty()) continue;
+        result.Add(t.letter.front());
     }
     return result;
 }
 
-void WordCounter::Subtract(const char c, const int k) {
-    map_[c - 65] -= k;
+bool scrabble::can_extend(const LetterHistogram &word, const LetterHistogram &stolen, const LetterHistogram &pool) {
+    // first check if *all letters* in stolenWord are in use, then that the rest comes from the pool
+    LetterHistogram remainder;
+    if (!word.TrySubtract(stolen, remainder)) return false;
+    return remainder.IsSubsetOf(pool);
 }
 
-bool scrabble::can_steal_word(const std::string &new_word, const Word &stolen_word, const GameState &game) {
-    for (auto &s: stolen_word.history) {
-        if (s == new_word) return false;
-    }
-
-    // first check if *all letters* in stolenWord are in use
-    auto stolenCounter = WordCounter{};
-    auto wordCounter = WordCounter{};
-    for (const auto c: new_word) {
-        wordCounter.InsertOrIncrement(c);
-    }
-    for (const auto c: stolen_word.history.front()) {
-        stolenCounter.InsertOrIncrement(c);
-    }
-
-    for (auto key : stolenCounter.Keys()) {
-        if (!wordCounter.ContainsKey(key)) return false;
-        wordCounter.Subtract(key, stolenCounter.Get(key));
-        if (wordCounter.Get(key) < 0) return false;
-    }
-
-    auto publicCounter = WordCounter{};
-
-    for (auto &t : game.tiles)
-    {
-        if (!t.faceUp) continue;
-        const char c = t.letter.front();
-        publicCounter.InsertOrIncrement(c);
+bool scrabble::in_history(const Word &word, const std::string_view candidate) {
+    for (auto &s: word.history) {
+        if (s == candidate) return true;
     }
+    return false;
+}
 
-    for (const auto key : wordCounter.Keys())
-    {
-        if (wordCounter.Get(key) == 0) continue;
-        //if (!publicCounter.ContainsKey(key)) return false;
-        if (publicCounter.Get(key) < wordCounter.Get(key)) {
-            return false;
-        }
-    }
+bool scrabble::can_steal_word(const std::string &new_word, const Word &stolen_word, const GameState &game) {
+    return can_steal_word(new_word, LetterHistogram::FromWord(new_word), stolen_word, public_histogram(game));
+}
 
-    return true;
+bool scrabble::can_steal_word(const std::string_view new_word,
+                              const LetterHistogram &new_word_letters,
+                              const Word &stolen_word,
+                              const LetterHistogram &public_letters) {
+    if (stolen_word.history.empty() || in_history(stolen_word, new_word)) return false;
+    const auto stolen = LetterHistogram::FromWord(stolen_word.history.front());
+    return can_extend(new_word_letters, stolen, public_letters);
 }
 
 std::optional<int> scrabble::get_tile_by_id(const std::string &id, const GameState &game) {
     int i = 0;
-    for (TileProps t : game.tiles ) {
+    for (const TileProps &t: game.tiles) {
         if (id == t.id) return i;
         i++;
     }
@@ -1,25 +1,43 @@
 #pragma once
 
-#include <vector>
 #include <string>
+#include <string_view>
 #include <optional>
 
+#include "letter_histogram.h"
+
 namespace scrabble {
     struct Word;
     struct GameState;
 
-    struct WordCounter {
-        [[nodiscard]] bool ContainsKey(char c) const;
-        void InsertOrIncrement(char c);
-        [[nodiscard]] int Get(char c) const;
-        [[nodiscard]] std::vector<char> Keys() const;
-        void Subtract(char c, int k);
+    /**
+     * Histogram of the face-up tiles in the public pool.
+     */
+    LetterHistogram public_histogram(const GameState &game);
+
+    /**
+     * Letter check only: stolen is contained in word, and what is left over is available in the pool.
+     */
+    bool can_extend(const LetterHistogram &word, const LetterHistogram &stolen, const LetterHistogram &pool);
 
-    private:
-        int map_[26] = {};
-    };
+    /**
+     * A word can't be stolen back into any form it has already had.
+     */
+    bool in_history(const Word &word, std::string_view candidate);
 
     bool can_steal_word(const std::string &new_word, const Word& stolen_word, const GameState &game);
 
+    /**
+     * Same as above, for callers that check one word against many candidates and have already
+     * built the new word and public pool histograms.
+     */
+    bool can_steal_word(std::string_view new_word,
+                        const LetterHistogram &new_word_letters,
+                        const Word &stolen_word,
+                        const LetterHistogram &public_letters);
+
+    /**
+     * Linear scan. Code that has a HandleTable for the snapshot should use TileIndex instead.
+     */
     std::optional<int> get_tile_by_id(const std::string &id, const GameState &game);
-}
\ No newline at end of file
+}
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCRABBLE_HISTOGRAM_SSE2 1
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#define SCRABBLE_HISTOGRAM_WASM 1
+#include <wasm_simd128.h>
+#elif defined(__aarch64__) // Across-vector reductions (vmaxvq_u8 and friends) are AArch64 only; ARMv7 goes scalar
+#define SCRABBLE_HISTOGRAM_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace scrabble {
+    constexpr int LETTER_COUNT = 26;
+
+    /**
+     * One bit per letter, bit 0 is 'A'.
+     */
+    using LetterMask = std::uint32_t;
+
+    constexpr LetterMask ALL_LETTERS_MASK = (1u << LETTER_COUNT) - 1;
+
+    /**
+     * Maps 'A'-'Z' (or 'a'-'z') to 0-25, anything else to -1.
+     */
+    constexpr int letter_index(const char c) {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a';
+        return -1;
+    }
+
+    /**
+     * Letter multiset packed into 32 byte-sized lanes (26 used, 6 always zero), so that
+     * subtract/compare/subset checks are two 16-byte vector ops instead of a loop.
+     *
+     * Counts saturate at 255, which is far above anything a 144 tile game can produce.
+     */
+    struct alignas(16) LetterHistogram {
+        std::uint8_t counts[32]{};
+
+        static LetterHistogram FromWord(const std::string_view word) {
+            LetterHistogram result;
+            for (const char c: word) result.Add(c);
+            return result;
+        }
+
+        void Add(const char c) {
+            if (const int i = letter_index(c); i >= 0 && counts[i] != 0xFF) counts[i]++;
+        }
+
+        void Remove(const char c) {
+            if (const int i = letter_index(c); i >= 0 && counts[i] != 0) counts[i]--;
+        }
+
+        [[nodiscard]] int Get(const char c) const {
+            const int i = letter_index(c);
+            return i >= 0 ? counts[i] : 0;
+        }
+
+        void Clear() {
+            std::memset(counts, 0, sizeof(counts));
+        }
+
+        /**
+         * True when every lane of this is <= the same lane of other, i.e. this is a sub-multiset.
+         */
+        [[nodiscard]] bool IsSubsetOf(const LetterHistogram &other) const;
+
+        /**
+         * Lane-wise max(0, this - other).
+         */
+        [[nodiscard]] LetterHistogram SaturatingSubtract(const LetterHistogram &other) const;
+
+        /**
+         * Lane-wise saturating sum.
+         */
+        [[nodiscard]] LetterHistogram SaturatingAdd(const LetterHistogram &other) const;
+
+        /**
+         * Writes this - other into out. Returns false (out unspecified) if other is not a sub-multiset of this.
+         */
+        [[nodiscard]] bool TrySubtract(const LetterHistogram &other, LetterHistogram &out) const {
+            if (!other.IsSubsetOf(*this)) return false;
+            out = SaturatingSubtract(other);
+            return true;
+        }
+
+        /**
+         * Bit i set when letter i has a nonzero count.
+         */
+        [[nodiscard]] LetterMask Mask() const;
+
+        /**
+         * Total number of letters.
+         */
+        [[nodiscard]] int Size() const;
+
+        bool operator==(const LetterHistogram &other) const;
+
+        bool operator!=(const LetterHistogram &other) const { return !(*this == other); }
+    };
+
+#if defined(SCRABBLE_HISTOGRAM_SSE2)
+    inline bool LetterHistogram::IsSubsetOf(const LetterHistogram &other) const {
+        const auto a0 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts));
+        const auto a1 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + 16));
+        const auto b0 = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts));
+        const auto b1 = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts + 16));
+        // a <= b in every lane iff saturating a - b is all zero
+        const auto over = _mm_or_si128(_mm_subs_epu8(a0, b0), _mm_subs_epu8(a1, b1));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingSubtract(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            const auto a = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + half));
+            const auto b = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts + half));
+            _mm_store_si128(reinterpret_cast<__m128i *>(result.counts + half), _mm_subs_epu8(a, b));
+        }
+        return result;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingAdd(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            const auto a = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + half));
+            const auto b = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts + half));
+            _mm_store_si128(reinterpret_cast<__m128i *>(result.counts + half), _mm_adds_epu8(a, b));
+        }
+        return result;
+    }
+
+    inline LetterMask LetterHistogram::Mask() const {
+        const auto zero = _mm_setzero_si128();
+        const auto a0 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts));
+        const auto a1 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + 16));
+        const auto empty = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a0, zero)))
+                           | static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a1, zero))) << 16;
+        return ~empty & ALL_LETTERS_MASK;
+    }
+
+    inline int LetterHistogram::Size() const {
+        const auto zero = _mm_setzero_si128();
+        const auto a0 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts));
+        const auto a1 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + 16));
+        const auto sum = _mm_add_epi64(_mm_sad_epu8(a0, zero), _mm_sad_epu8(a1, zero));
+        return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+    }
+
+    inline bool LetterHistogram::operator==(const LetterHistogram &other) const {
+        const auto a0 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts));
+        const auto a1 = _mm_load_si128(reinterpret_cast<const __m128i *>(counts + 16));
+        const auto b0 = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts));
+        const auto b1 = _mm_load_si128(reinterpret_cast<const __m128i *>(other.counts + 16));
+        const auto eq = _mm_and_si128(_mm_cmpeq_epi8(a0, b0), _mm_cmpeq_epi8(a1, b1));
+        return _mm_movemask_epi8(eq) == 0xFFFF;
+    }
+#elif defined(SCRABBLE_HISTOGRAM_WASM)
+    inline bool LetterHistogram::IsSubsetOf(const LetterHistogram &other) const {
+        const auto over = wasm_v128_or(
+            wasm_u8x16_sub_sat(wasm_v128_load(counts), wasm_v128_load(other.counts)),
+            wasm_u8x16_sub_sat(wasm_v128_load(counts + 16), wasm_v128_load(other.counts + 16)));
+        return !wasm_v128_any_true(over);
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingSubtract(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            wasm_v128_store(result.counts + half,
+                            wasm_u8x16_sub_sat(wasm_v128_load(counts + half), wasm_v128_load(other.counts + half)));
+        }
+        return result;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingAdd(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            wasm_v128_store(result.counts + half,
+                            wasm_u8x16_add_sat(wasm_v128_load(counts + half), wasm_v128_load(other.counts + half)));
+        }
+        return result;
+    }
+
+    inline LetterMask LetterHistogram::Mask() const {
+        const auto zero = wasm_i8x16_splat(0);
+        const auto lo = wasm_i8x16_bitmask(wasm_i8x16_ne(wasm_v128_load(counts), zero));
+        const auto hi = wasm_i8x16_bitmask(wasm_i8x16_ne(wasm_v128_load(counts + 16), zero));
+        return (static_cast<LetterMask>(lo) | static_cast<LetterMask>(hi) << 16) & ALL_LETTERS_MASK;
+    }
+
+    inline int LetterHistogram::Size() const {
+        const auto sum = wasm_u16x8_extadd_pairwise_u8x16(wasm_v128_load(counts));
+        const auto sum_hi = wasm_u16x8_extadd_pairwise_u8x16(wasm_v128_load(counts + 16));
+        const auto total = wasm_u32x4_extadd_pairwise_u16x8(wasm_i16x8_add(sum, sum_hi));
+        return static_cast<int>(wasm_u32x4_extract_lane(total, 0) + wasm_u32x4_extract_lane(total, 1)
+                                + wasm_u32x4_extract_lane(total, 2) + wasm_u32x4_extract_lane(total, 3));
+    }
+
+    inline bool LetterHistogram::operator==(const LetterHistogram &other) const {
+        const auto eq = wasm_v128_and(
+            wasm_i8x16_eq(wasm_v128_load(counts), wasm_v128_load(other.counts)),
+            wasm_i8x16_eq(wasm_v128_load(counts + 16), wasm_v128_load(other.counts + 16)));
+        return wasm_i8x16_all_true(eq);
+    }
+#elif defined(SCRABBLE_HISTOGRAM_NEON)
+    inline bool LetterHistogram::IsSubsetOf(const LetterHistogram &other) const {
+        const auto over = vorrq_u8(vqsubq_u8(vld1q_u8(counts), vld1q_u8(other.counts)),
+                                   vqsubq_u8(vld1q_u8(counts + 16), vld1q_u8(other.counts + 16)));
+        return vmaxvq_u8(over) == 0;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingSubtract(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            vst1q_u8(result.counts + half, vqsubq_u8(vld1q_u8(counts + half), vld1q_u8(other.counts + half)));
+        }
+        return result;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingAdd(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int half = 0; half < 32; half += 16) {
+            vst1q_u8(result.counts + half, vqaddq_u8(vld1q_u8(counts + half), vld1q_u8(other.counts + half)));
+        }
+        return result;
+    }
+
+    inline LetterMask LetterHistogram::Mask() const {
+        LetterMask mask = 0;
+        for (int i = 0; i < LETTER_COUNT; i++) {
+            if (counts[i]) mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    inline int LetterHistogram::Size() const {
+        return static_cast<int>(vaddlvq_u8(vld1q_u8(counts)) + vaddlvq_u8(vld1q_u8(counts + 16)));
+    }
+
+    inline bool LetterHistogram::operator==(const LetterHistogram &other) const {
+        const auto eq = vandq_u8(vceqq_u8(vld1q_u8(counts), vld1q_u8(other.counts)),
+                                 vceqq_u8(vld1q_u8(counts + 16), vld1q_u8(other.counts + 16)));
+        return vminvq_u8(eq) == 0xFF;
+    }
+#else
+    inline bool LetterHistogram::IsSubsetOf(const LetterHistogram &other) const {
+        for (int i = 0; i < LETTER_COUNT; i++) {
+            if (counts[i] > other.counts[i]) return false;
+        }
+        return true;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingSubtract(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int i = 0; i < LETTER_COUNT; i++) {
+            result.counts[i] = counts[i] > other.counts[i] ? counts[i] - other.counts[i] : 0;
+        }
+        return result;
+    }
+
+    inline LetterHistogram LetterHistogram::SaturatingAdd(const LetterHistogram &other) const {
+        LetterHistogram result;
+        for (int i = 0; i < LETTER_COUNT; i++) {
+            const int sum = counts[i] + other.counts[i];
+            result.counts[i] = static_cast<std::uint8_t>(sum > 0xFF ? 0xFF : sum);
+        }
+        return result;
+    }
+
+    inline LetterMask LetterHistogram::Mask() const {
+        LetterMask mask = 0;
+        for (int i = 0; i < LETTER_COUNT; i++) {
+            if (counts[i]) mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    inline int LetterHistogram::Size() const {
+        int size = 0;
+        for (int i = 0; i < LETTER_COUNT; i++) size += counts[i];
+        return size;
+    }
+
+    inline bool LetterHistogram::operator==(const LetterHistogram &other) const {
+        return std::memcmp(counts, other.counts, sizeof(counts)) == 0;
+    }
+#endif
+
+    /**
+     * FNV-1a over the used lanes, so histograms can key hash maps (anagram signatures).
+     */
+    struct LetterHistogramHash {
+        std::size_t operator()(const LetterHistogram &h) const {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (int i = 0; i < LETTER_COUNT; i++) {
+                hash ^= h.counts[i];
+                hash *= 1099511628211ull;
+            }
+            return static_cast<std::size_t>(hash);
+        }
+    };
+
+    /**
+     * Cheap pre-filter before the full subset check: a can only be a sub-multiset of b
+     * if every letter of a appears in b at all.
+     */
+    constexpr bool mask_is_subset(const LetterMask a, const LetterMask b) {
+        return (a & ~b) == 0;
+    }
+}
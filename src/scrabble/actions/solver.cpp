@@ -0,0 +1,85 @@
+#include "solver.h"
+
+#include <algorithm>
+
+#include "anagram_index.h"
+#include "legal_actions.h"
+#include "scrabble/context/types.h"
+#include "util/thread_pool/cancel_token.h"
+
+using namespace scrabble;
+
+void scrabble::build_solver_board(const GameState &game, SolverBoard &board) {
+    board.pool = public_histogram(game);
+    board.pool_mask = board.pool.Mask();
+    board.pool_size = board.pool.Size();
+    board.minimum_length = std::max(game.wordMinimumSize, 1);
+    board.targets.clear();
+    board.targets.push_back({-1, nullptr, {}, 0, 0, board.pool, board.pool_mask});
+    for (int player = 0; player < static_cast<int>(game.playerWords.size()); player++) {
+        for (const auto &word: game.playerWords[player]) {
+            if (word.history.empty()) continue;
+            const auto letters = LetterHistogram::FromWord(word.history.front());
+            const auto available = letters.SaturatingAdd(board.pool);
+            board.targets.push_back({
+                player, &word, letters, letters.Mask(), letters.Size(), available, available.Mask()
+            });
+        }
+    }
+}
+
+std::pair<size_t, size_t> scrabble::target_class_range(const AnagramIndex &index, const SolverBoard &board,
+                                                       const ClaimTarget &target) {
+    const auto shortest = static_cast<std::uint32_t>(std::max(board.minimum_length, target.length));
+    const auto longest = static_cast<std::uint32_t>(board.pool_size + target.length);
+    const size_t begin = index.FirstClassOfLength(shortest);
+    return {begin, std::max(begin, index.FirstClassOfLength(longest + 1))};
+}
+
+bool scrabble::solve_target_slice(const AnagramIndex &index, const ClaimTarget &target,
+                                  const size_t begin, const size_t end,
+                                  std::vector<Claim> &out, const CancelToken *cancel) {
+    constexpr size_t CANCEL_CHECK_INTERVAL = 4096;
+    const auto &classes = index.Classes();
+    const auto &masks = index.Masks();
+    for (size_t i = begin; i < end; i++) {
+        if (cancel && i % CANCEL_CHECK_INTERVAL == 0 && cancel->Expired()) return false;
+        // Masks first: most classes use a letter that isn't available at all
+        const LetterMask mask = masks[i];
+        if (!mask_is_subset(mask, target.available_mask)) continue;
+        if (!mask_is_subset(target.mask, mask)) continue;
+        const auto &c = classes[i];
+        if (!c.letters.IsSubsetOf(target.available)) continue;
+        if (!target.letters.IsSubsetOf(c.letters)) continue;
+        for (std::uint32_t w = c.first_word; w < c.first_word + c.word_count; w++) {
+            const auto word = index.Word(w);
+            if (target.word && in_history(*target.word, word)) continue;
+            out.push_back({word, target.player, target.word, target.length});
+        }
+    }
+    return true;
+}
+
+bool scrabble::solve_target(const AnagramIndex &index, const SolverBoard &board, const ClaimTarget &target,
+                            std::vector<Claim> &out, const CancelToken *cancel) {
+    const auto [begin, end] = target_class_range(index, board, target);
+    return solve_target_slice(index, target, begin, end, out, cancel);
+}
+
+void scrabble::rank_claims(std::vector<Claim> &claims) {
+    std::sort(claims.begin(), claims.end(), [](const Claim &a, const Claim &b) {
+        if (a.word.size() != b.word.size()) return a.word.size() > b.word.size();
+        if (a.stolen_length != b.stolen_length) return a.stolen_length > b.stolen_length;
+        if (a.word != b.word) return a.word < b.word;
+        return a.player < b.player;
+    });
+}
+
+void scrabble::solve_claims(const GameState &game, const AnagramIndex &index, std::vector<Claim> &out) {
+    SolverBoard board;
+    build_solver_board(game, board);
+    for (const auto &target: board.targets) {
+        solve_target(index, board, target, out);
+    }
+    rank_claims(out);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "letter_histogram.h"
+
+class CancelToken;
+
+namespace scrabble {
+    struct Word;
+    struct GameState;
+    class AnagramIndex;
+
+    /**
+     * What a claim is built on: the public pool alone, or a claimed word plus pool tiles.
+     */
+    struct ClaimTarget {
+        int player; // -1 for the public pool
+        const Word *word; // nullptr for the public pool
+        LetterHistogram letters; // Letters of the stolen word (empty for the pool)
+        LetterMask mask;
+        int length;
+        LetterHistogram available; // letters + pool
+        LetterMask available_mask;
+    };
+
+    struct Claim {
+        std::string_view word; // Points into the AnagramIndex
+        int player; // Owner of the stolen word, -1 when claimed from the pool
+        const Word *stolen; // nullptr when claimed from the pool
+        int stolen_length;
+    };
+
+    /**
+     * Everything the search needs from a GameState, computed once per board.
+     */
+    struct SolverBoard {
+        LetterHistogram pool;
+        LetterMask pool_mask{0};
+        int pool_size{0};
+        int minimum_length{0};
+        std::vector<ClaimTarget> targets; // Pool target first, then every claimed word
+    };
+
+    /**
+     * Pointers in board.targets refer into game, which must outlive the board.
+     */
+    void build_solver_board(const GameState &game, SolverBoard &board);
+
+    /**
+     * The slice of AnagramIndex::Classes() a target can reach: no shorter than the stolen word
+     * (or the minimum), no longer than the stolen word plus the whole pool.
+     */
+    std::pair<size_t, size_t> target_class_range(const AnagramIndex &index, const SolverBoard &board,
+                                                 const ClaimTarget &target);
+
+    /**
+     * solve_target restricted to classes [begin, end), so one large target can be split up.
+     */
+    bool solve_target_slice(const AnagramIndex &index, const ClaimTarget &target, size_t begin, size_t end,
+                            std::vector<Claim> &out, const CancelToken *cancel = nullptr);
+
+    /**
+     * Appends every legal claim built on one target. Targets are independent of each other.
+     * Polls cancel (if given) as it goes and returns false if it gave up early.
+     */
+    bool solve_target(const AnagramIndex &index, const SolverBoard &board, const ClaimTarget &target,
+                      std::vector<Claim> &out, const CancelToken *cancel = nullptr);
+
+    /**
+     * Longest new word first; for equal length, steals of longer words before pool claims.
+     */
+    void rank_claims(std::vector<Claim> &claims);
+
+    /**
+     * Every legal claim on the board, ranked. Same rules as can_steal_word, plus wordMinimumSize.
+     */
+    void solve_claims(const GameState &game, const AnagramIndex &index, std::vector<Claim> &out);
+}
@@ -0,0 +1,107 @@
+#include "steal_index.h"
+
+#include <algorithm>
+
+#include "legal_actions.h"
+
+using namespace scrabble;
+
+void StealIndex::Rebuild(const GameState &game) {
+    Clear();
+    words_ = game.playerWords;
+    for (int player = 0; player < static_cast<int>(words_.size()); player++) {
+        AddPlayerRefs(player);
+    }
+}
+
+void StealIndex::RebuildPlayer(const GameState &game, const int player) {
+    if (player < 0 || player >= static_cast<int>(game.playerWords.size())) return;
+    if (words_.size() != game.playerWords.size()) {
+        Rebuild(game);
+        return;
+    }
+    RemovePlayerRefs(player);
+    words_[player] = game.playerWords[player];
+    AddPlayerRefs(player);
+    version_++;
+}
+
+bool StealIndex::Sync(const GameState &game) {
+    if (words_.size() != game.playerWords.size()) {
+        Rebuild(game);
+        return true;
+    }
+    bool changed = false;
+    for (int player = 0; player < static_cast<int>(words_.size()); player++) {
+        const auto &indexed = words_[player];
+        const auto &current = game.playerWords[player];
+        bool same = indexed.size() == current.size();
+        for (size_t i = 0; same && i < current.size(); i++) {
+            // Handles are only set on interned snapshots; fall back to the string id otherwise
+            const bool same_id = indexed[i].handle >= 0
+                                     ? indexed[i].handle == current[i].handle
+                                     : indexed[i].id == current[i].id;
+            same = same_id && indexed[i].history == current[i].history;
+        }
+        if (!same) {
+            RebuildPlayer(game, player);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void StealIndex::Clear() {
+    words_.clear();
+    buckets_.clear();
+    signature_lookup_.clear();
+    version_++;
+}
+
+void StealIndex::Query(const std::string_view word,
+                       const LetterHistogram &word_letters,
+                       const LetterHistogram &pool,
+                       std::vector<StealCandidate> &out) const {
+    const auto first = out.size();
+    const LetterMask word_mask = word_letters.Mask();
+    for (const auto &bucket: buckets_) {
+        if (bucket.refs.empty()) continue;
+        if (!mask_is_subset(bucket.mask, word_mask)) continue;
+        if (!can_extend(word_letters, bucket.letters, pool)) continue;
+        for (const auto &[player, index]: bucket.refs) {
+            const Word &stolen = words_[player][index];
+            if (in_history(stolen, word)) continue;
+            out.push_back({player, &stolen, bucket.length});
+        }
+    }
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+              [](const StealCandidate &a, const StealCandidate &b) {
+                  if (a.length != b.length) return a.length > b.length;
+                  return a.player < b.player;
+              });
+}
+
+size_t StealIndex::WordCount() const {
+    size_t count = 0;
+    for (const auto &words: words_) count += words.size();
+    return count;
+}
+
+void StealIndex::AddPlayerRefs(const int player) {
+    const auto &words = words_[player];
+    for (int index = 0; index < static_cast<int>(words.size()); index++) {
+        if (words[index].history.empty()) continue;
+        const auto letters = LetterHistogram::FromWord(words[index].history.front());
+        auto [it, inserted] = signature_lookup_.try_emplace(letters, buckets_.size());
+        if (inserted) {
+            buckets_.push_back({letters, letters.Mask(), letters.Size(), {}});
+        }
+        buckets_[it->second].refs.push_back({player, index});
+    }
+}
+
+void StealIndex::RemovePlayerRefs(const int player) {
+    for (auto &bucket: buckets_) {
+        std::erase_if(bucket.refs, [player](const Ref &ref) { return ref.player == player; });
+    }
+}
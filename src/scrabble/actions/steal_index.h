@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "letter_histogram.h"
+#include "scrabble/context/types.h"
+
+namespace scrabble {
+    struct StealCandidate {
+        int player;
+        const Word *word; // Owned by the StealIndex, valid until its next rebuild
+        int length;
+    };
+
+    /**
+     * Every claimed word on the board, grouped by letter multiset.
+     *
+     * A typed word only has to be checked against each distinct multiset once, and most groups
+     * are rejected by the 26-bit mask test before the histogram is even looked at.
+     */
+    class StealIndex {
+    public:
+        void Rebuild(const GameState &game);
+
+        /**
+         * Re-index one player's words. A claim only changes the acting and stolen players.
+         */
+        void RebuildPlayer(const GameState &game, int player);
+
+        /**
+         * Re-index any player whose words differ (by count or id) from the snapshot.
+         * Returns true if anything had to be rebuilt.
+         */
+        bool Sync(const GameState &game);
+
+        void Clear();
+
+        /**
+         * Appends the words that `word` can legally steal given the public pool, best first:
+         * longest stolen word, then lowest player index.
+         */
+        void Query(std::string_view word,
+                   const LetterHistogram &word_letters,
+                   const LetterHistogram &pool,
+                   std::vector<StealCandidate> &out) const;
+
+        [[nodiscard]] size_t WordCount() const;
+
+        [[nodiscard]] size_t SignatureCount() const { return signature_lookup_.size(); }
+
+        struct Ref {
+            int player;
+            int index;
+        };
+
+        /**
+         * All claimed words sharing one letter multiset. May be empty after a re-index.
+         */
+        struct Bucket {
+            LetterHistogram letters;
+            LetterMask mask;
+            int length;
+            std::vector<Ref> refs;
+        };
+
+        [[nodiscard]] const std::vector<Bucket> &Buckets() const { return buckets_; }
+
+        [[nodiscard]] const Word &WordAt(const Ref ref) const { return words_[ref.player][ref.index]; }
+
+        /**
+         * Bumped on every change, so anything derived from the index can tell it is stale.
+         */
+        [[nodiscard]] std::uint64_t Version() const { return version_; }
+
+    private:
+        void AddPlayerRefs(int player);
+
+        void RemovePlayerRefs(int player);
+
+        std::vector<std::vector<Word> > words_;
+
+        std::vector<Bucket> buckets_;
+
+        std::unordered_map<LetterHistogram, size_t, LetterHistogramHash> signature_lookup_;
+
+        std::uint64_t version_{0};
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "letter_histogram.h"
+
+namespace scrabble {
+    constexpr int TILE_TOTAL = 144;
+
+    /**
+     * Number of tiles of each letter in a full 144 tile set, 'A' first.
+     */
+    constexpr int TILE_DISTRIBUTION[LETTER_COUNT] = {
+        13, 3, 3, 6, 18, 3, 4, 3, 12, 2, 2, 5, 3, 8, 11, 3, 2, 9, 6, 9, 6, 3, 3, 2, 3, 2
+    };
+}
@@ -0,0 +1,37 @@
+#include "tile_pool_index.h"
+
+using namespace scrabble;
+
+void TilePoolIndex::Rebuild(const LetterHistogram &letters, const int hash_code) {
+    letters_ = letters;
+    size_ = letters_.Size();
+    hash_code_ = hash_code;
+    version_++;
+}
+
+void TilePoolIndex::Flip(const char letter) {
+    const int i = letter_index(letter);
+    if (i < 0) return;
+    letters_.Add(letter);
+    size_++;
+    version_++;
+}
+
+void TilePoolIndex::Remove(const char letter) {
+    const int i = letter_index(letter);
+    if (i < 0 || letters_.counts[i] == 0) return;
+    letters_.Remove(letter);
+    size_--;
+    version_++;
+}
+
+void TilePoolIndex::SetHashCode(const int hash_code) {
+    hash_code_ = hash_code;
+}
+
+void TilePoolIndex::Clear() {
+    letters_.Clear();
+    size_ = 0;
+    hash_code_ = std::nullopt;
+    version_++;
+}
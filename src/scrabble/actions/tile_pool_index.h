@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "letter_histogram.h"
+
+namespace scrabble {
+    /**
+     * Letters currently face up in the public pool.
+     *
+     * Kept current by feeding it the flips and claims seen in MultiplayerContext, and only
+     * rebuilt from a full snapshot when a server state change can't be explained by those.
+     */
+    class TilePoolIndex {
+    public:
+        /**
+         * Reset to a snapshot's face-up letters (public_histogram) and remember the server hash
+         * it corresponds to.
+         */
+        void Rebuild(const LetterHistogram &letters, int hash_code);
+
+        /**
+         * A tile with this letter was turned face up.
+         */
+        void Flip(char letter);
+
+        /**
+         * A face-up tile with this letter left the pool (claimed into a word).
+         */
+        void Remove(char letter);
+
+        void SetHashCode(int hash_code);
+
+        void Clear();
+
+        [[nodiscard]] int Count(const char letter) const { return letters_.Get(letter); }
+
+        [[nodiscard]] int Size() const { return size_; }
+
+        [[nodiscard]] const LetterHistogram &Letters() const { return letters_; }
+
+        [[nodiscard]] std::optional<int> HashCode() const { return hash_code_; }
+
+        /**
+         * Bumped on every change, so anything derived from the pool can tell it is stale.
+         */
+        [[nodiscard]] std::uint64_t Version() const { return version_; }
+
+    private:
+        LetterHistogram letters_{};
+
+        int size_{0};
+
+        std::optional<int> hash_code_{std::nullopt};
+
+        std::uint64_t version_{0};
+    };
+}
@@ -0,0 +1,155 @@
+#include "word_cursor.h"
+
+#include "legal_actions.h"
+#include "tile_pool_index.h"
+
+using namespace scrabble;
+
+void WordCursor::Track(const TilePoolIndex &pool,
+                       const StealIndex &words,
+                       const std::shared_ptr<const Dictionary> &dictionary,
+                       const int minimum_length) {
+    if (words_ == &words && pool_version_ == pool.Version() && words_version_ == words.Version()
+        && dictionary_ == dictionary && minimum_length_ == minimum_length) {
+        return;
+    }
+    words_ = &words;
+    pool_ = pool.Letters();
+    pool_version_ = pool.Version();
+    words_version_ = words.Version();
+    dictionary_ = dictionary;
+    minimum_length_ = minimum_length;
+    Retarget();
+}
+
+void WordCursor::Retarget() {
+    targets_.clear();
+    targets_.push_back({LetterHistogram{}, 0, 0, POOL_TARGET});
+    if (words_) {
+        const auto &buckets = words_->Buckets();
+        for (std::uint32_t i = 0; i < buckets.size(); i++) {
+            if (buckets[i].refs.empty()) continue;
+            targets_.push_back({buckets[i].letters, buckets[i].length, buckets[i].length, i});
+        }
+    }
+    const std::string text = std::move(text_);
+    Clear();
+    for (const char c: text) Push(c);
+}
+
+void WordCursor::Clear() {
+    text_.clear();
+    typed_.Clear();
+    prefixes_.clear();
+    prefixes_.push_back(dictionary_ ? dictionary_->Root() : DawgCursor{});
+    for (auto &target: targets_) target.missing = target.length;
+    alive_.clear();
+    for (std::uint32_t i = 0; i < targets_.size(); i++) alive_.push_back(i);
+    killed_.clear();
+    killed_marks_.clear();
+    Evaluate();
+}
+
+void WordCursor::Push(const char c) {
+    if (prefixes_.empty()) Clear();
+    text_.push_back(c);
+    killed_marks_.push_back(static_cast<std::uint32_t>(killed_.size()));
+    prefixes_.push_back(dictionary_ ? dictionary_->Step(prefixes_.back(), c) : DawgCursor{});
+
+    const int lane = letter_index(c);
+    if (lane < 0) {
+        // Not a tile letter, nothing can be claimed
+        killed_.insert(killed_.end(), alive_.begin(), alive_.end());
+        alive_.clear();
+        Evaluate();
+        return;
+    }
+    typed_.counts[lane]++;
+    const int typed = typed_.counts[lane];
+    for (size_t i = alive_.size(); i-- > 0;) {
+        auto &target = targets_[alive_[i]];
+        if (typed <= target.letters.counts[lane]) {
+            target.missing--;
+        } else if (typed - target.letters.counts[lane] > pool_.counts[lane]) {
+            killed_.push_back(alive_[i]);
+            alive_[i] = alive_.back();
+            alive_.pop_back();
+        }
+    }
+    Evaluate();
+}
+
+void WordCursor::Pop() {
+    if (text_.empty()) return;
+    const char c = text_.back();
+    text_.pop_back();
+    prefixes_.pop_back();
+
+    if (const int lane = letter_index(c); lane >= 0) {
+        // Undo the coverage counted by the push, for targets that survived it
+        const int typed = typed_.counts[lane];
+        for (const auto index: alive_) {
+            auto &target = targets_[index];
+            if (typed <= target.letters.counts[lane]) target.missing++;
+        }
+        typed_.counts[lane]--;
+    }
+    const auto mark = killed_marks_.back();
+    killed_marks_.pop_back();
+    alive_.insert(alive_.end(), killed_.begin() + mark, killed_.end());
+    killed_.resize(mark);
+    Evaluate();
+}
+
+void WordCursor::SyncTo(const std::string_view text) {
+    size_t common = 0;
+    while (common < text.size() && common < text_.size() && text[common] == text_[common]) common++;
+    while (text_.size() > common) Pop();
+    for (size_t i = common; i < text.size(); i++) Push(text[i]);
+}
+
+void WordCursor::Evaluate() {
+    best_steal_.reset();
+    if (text_.empty()) {
+        status_ = WordFeasibility::Empty;
+        return;
+    }
+    if (dictionary_ && !prefixes_.back().valid) {
+        status_ = WordFeasibility::NotAWord;
+        return;
+    }
+    if (alive_.empty()) {
+        status_ = WordFeasibility::Impossible;
+        return;
+    }
+    const bool is_word = !dictionary_ || prefixes_.back().terminal;
+    if (!is_word || static_cast<int>(text_.size()) < minimum_length_) {
+        status_ = WordFeasibility::Incomplete;
+        return;
+    }
+
+    // Same ranking as StealIndex::Query: longest stolen word, then lowest player index
+    bool pool_alive = false;
+    for (const auto index: alive_) {
+        const auto &target = targets_[index];
+        if (target.bucket == POOL_TARGET) {
+            pool_alive = true;
+            continue;
+        }
+        if (target.missing != 0) continue;
+        if (best_steal_ && best_steal_->length > target.length) continue;
+        for (const auto ref: words_->Buckets()[target.bucket].refs) {
+            const Word &word = words_->WordAt(ref);
+            if (in_history(word, text_)) continue;
+            if (best_steal_ && best_steal_->length == target.length && best_steal_->player <= ref.player) continue;
+            best_steal_ = StealCandidate{ref.player, &word, target.length};
+        }
+    }
+    if (best_steal_) {
+        status_ = WordFeasibility::Steal;
+    } else if (pool_alive) {
+        status_ = WordFeasibility::FromPool;
+    } else {
+        status_ = WordFeasibility::Incomplete;
+    }
+}
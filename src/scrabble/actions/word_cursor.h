@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "letter_histogram.h"
+#include "steal_index.h"
+#include "scrabble/dictionary/dawg.h"
+
+namespace scrabble {
+    class TilePoolIndex;
+
+    enum class WordFeasibility {
+        Empty,
+        NotAWord, // No dictionary word starts with what has been typed
+        Impossible, // Too many of some letter for the pool plus any claimed word
+        Incomplete, // Still reachable, but not a claim as typed
+        FromPool, // Claimable from the public pool alone
+        Steal, // Claimable by stealing BestSteal()
+    };
+
+    /**
+     * Tracks a word as it is typed, one character at a time, and keeps its claim status current.
+     *
+     * Every claim target (the public pool, and each distinct claimed-word multiset) stays
+     * "reachable" until the typed word has more of some letter than the target plus the pool can
+     * supply. Typing only ever adds letters, so a target that dies stays dead until backspace.
+     * A keystroke therefore touches only the lane of the typed letter for each live target,
+     * plus one dictionary edge list.
+     */
+    class WordCursor {
+    public:
+        /**
+         * Re-targets against the current board if anything changed since the last call, replaying
+         * the text typed so far. Cheap to call every frame.
+         */
+        void Track(const TilePoolIndex &pool,
+                   const StealIndex &words,
+                   const std::shared_ptr<const Dictionary> &dictionary,
+                   int minimum_length);
+
+        void Push(char c);
+
+        void Pop();
+
+        /**
+         * Pops back to the common prefix with text and pushes the rest.
+         */
+        void SyncTo(std::string_view text);
+
+        void Clear();
+
+        [[nodiscard]] WordFeasibility Status() const { return status_; }
+
+        [[nodiscard]] std::optional<StealCandidate> BestSteal() const { return best_steal_; }
+
+        [[nodiscard]] std::string_view Text() const { return text_; }
+
+        [[nodiscard]] size_t ReachableTargetCount() const { return alive_.size(); }
+
+    private:
+        static constexpr std::uint32_t POOL_TARGET = UINT32_MAX;
+
+        struct Target {
+            LetterHistogram letters;
+            int length;
+            int missing; // Letters of this target not yet covered by the typed word
+            std::uint32_t bucket; // Index into StealIndex::Buckets(), or POOL_TARGET
+        };
+
+        void Retarget();
+
+        void Evaluate();
+
+        const StealIndex *words_{nullptr};
+
+        std::shared_ptr<const Dictionary> dictionary_;
+
+        LetterHistogram pool_{};
+
+        int minimum_length_{0};
+
+        std::uint64_t pool_version_{UINT64_MAX};
+
+        std::uint64_t words_version_{UINT64_MAX};
+
+        std::string text_;
+
+        LetterHistogram typed_{};
+
+        std::vector<DawgCursor> prefixes_; // prefixes_[i] is the dictionary position after i letters
+
+        std::vector<Target> targets_;
+
+        std::vector<std::uint32_t> alive_;
+
+        std::vector<std::uint32_t> killed_; // Targets killed by each push, in push order
+
+        std::vector<std::uint32_t> killed_marks_; // Size of killed_ before each push
+
+        WordFeasibility status_{WordFeasibility::Empty};
+
+        std::optional<StealCandidate> best_steal_;
+    };
+}
@@ -1,8 +1,6 @@
 #include "login.h"
 
-#include <functional>
 #include <string>
-#include <thread>
 
 #include <imgui.h>
 #include <imgui_stdlib.h>
@@ -15,20 +13,22 @@
 
 using namespace scrabble;
 
-void LoginContext::Update(float delta_time) {
-    std::string msg;
-    while (recv_login_queue.try_dequeue(msg)) {
-        auto response = deserialize<UserResponse>(msg);
-        if (main_menu->state == MainMenuContext::State::InitialLoading) {
-            main_menu->state = MainMenuContext::State::Menu;
-        }
-        if (response.ok) {
-            Logger::instance().info("Authenticated as {}", response.user->username);
-            main_menu->user_opt = response.user.value();
-            state = State::Bypassed;
-        } else {
-            state = State::Active;
-        }
+void LoginContext::HandleAuthResult(const ConnectionManager::Result &result) {
+    if (main_menu->state == MainMenuContext::State::InitialLoading) {
+        main_menu->state = MainMenuContext::State::Menu;
+    }
+    if (!result.Ok()) {
+        Logger::instance().error("Auth request failed: {}", result.message);
+        ShowForm();
+        return;
+    }
+    auto response = deserialize<UserResponse>(result.message);
+    if (response.ok) {
+        Logger::instance().info("Authenticated as {}", response.user->username);
+        main_menu->user_opt = response.user.value();
+        state = State::Bypassed;
+    } else {
+        ShowForm();
     }
 }
 
@@ -41,15 +41,19 @@ void LoginContext::Draw() {
         const bool b3 = ImGui::Button("Log in");
         if (b1 || b2 || b3) {
             // todo: loading state
-            // do we even need a thread, we can use main thread to release the socket...
-            std::thread t(UserLoginSocket, std::ref(recv_login_queue), username_label, password_label);
-            t.detach();
+            request_user_login(*main_menu->api, username_label, password_label,
+                               [this](const ConnectionManager::Result &result) { HandleAuthResult(result); });
         }
         ImGui::End();
     }
 }
 
 void LoginContext::AttemptTokenAuth(const std::string &token) {
-    std::thread t(TokenAuthSocket, std::ref(recv_login_queue), token);
-    t.detach();
+    request_token_auth(*main_menu->api, token,
+                       [this](const ConnectionManager::Result &result) { HandleAuthResult(result); });
+}
+
+void LoginContext::ShowForm() {
+    state = State::Active;
+    main_menu->api->Warm(login_path);
 }
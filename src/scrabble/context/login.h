@@ -3,7 +3,7 @@
 #include <string>
 
 #include "game_object/game_object.h"
-#include "util/queue.h"
+#include "util/network/connection_manager.h"
 
 namespace scrabble {
     struct MainMenuContext;
@@ -18,18 +18,24 @@ namespace scrabble {
 
         MainMenuContext *main_menu;
 
-        Queue recv_login_queue;
-
         State state = State::PreLogin;
 
         std::string username_label;
 
         std::string password_label;
 
-        void Update(float delta_time) override;
-
         void Draw() override;
 
         void AttemptTokenAuth(const std::string &token);
+
+        /**
+         * Shows the login form and opens the login connection while the user types.
+         */
+        void ShowForm();
+
+        /**
+         * Completion of a login or token auth request. A failed request shows the login form.
+         */
+        void HandleAuthResult(const ConnectionManager::Result &result);
     };
 }
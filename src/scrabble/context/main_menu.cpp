@@ -9,6 +9,7 @@
 
 #include "login.h"
 #include "multiplayer.h"
+#include "socket_client.h"
 #include "util/filesystem/filesystem.h"
 #include "util/logging/logging.h"
 #include "types.h"
@@ -18,6 +19,11 @@ using namespace scrabble;
 MainMenuContext::MainMenuContext(std::function<void()> request_exit)
     : login_context(new LoginContext()),
       multiplayer_context(new MultiplayerContext()),
+      network(create_network_simulator()),
+      recorder(create_socket_recorder()),
+      replay(create_capture_replay()),
+      make_socket(create_socket_factory(network, recorder, replay)),
+      api(create_api_connections(make_socket)),
       request_exit_hook(std::move(request_exit)) {
     Logger::instance().info("Initializing main context");
     AddChild(login_context);
@@ -57,6 +63,9 @@ void MainMenuContext::Draw() {
 }
 
 void MainMenuContext::Update(const float delta_time) {
+    if (replay != nullptr) replay->Pump();
+    network->Pump();
+    api->Poll();
     switch (state) {
         case State::InitialLoading: {
             /*
@@ -113,6 +122,63 @@ void MainMenuContext::RenderMainMenu() {
     ImGui::End();
 }
 
+void MainMenuContext::RenderNetworkDebug() {
+    auto conditions = network->Conditions();
+    bool changed = ImGui::Checkbox("Simulate network", &conditions.enabled);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(160.0f);
+    if (ImGui::BeginCombo("##network_preset", "Preset")) {
+        for (const auto &preset: network_presets()) {
+            if (ImGui::Selectable(preset.name)) {
+                conditions = preset.conditions;
+                changed = true;
+            }
+        }
+        ImGui::EndCombo();
+    }
+    if (ImGui::TreeNode("Network conditions")) {
+        const auto link_sliders = [&](const char *label, LinkConditions &link) {
+            ImGui::PushID(label);
+            ImGui::Text("%s", label);
+            changed |= ImGui::SliderFloat("Latency ms", &link.latency_ms, 0.0f, 1000.0f, "%.0f");
+            changed |= ImGui::SliderFloat("Jitter ms", &link.jitter_ms, 0.0f, 1000.0f, "%.0f");
+            changed |= ImGui::SliderFloat("Bandwidth kbps (0 = unlimited)", &link.bandwidth_kbps, 0.0f, 50000.0f,
+                                          "%.0f", ImGuiSliderFlags_Logarithmic);
+            changed |= ImGui::SliderFloat("Drop rate", &link.drop_rate, 0.0f, 0.5f, "%.3f");
+            changed |= ImGui::SliderFloat("Reorder rate", &link.reorder_rate, 0.0f, 0.5f, "%.3f");
+            ImGui::PopID();
+        };
+        link_sliders("Upstream", conditions.upstream);
+        link_sliders("Downstream", conditions.downstream);
+        if (ImGui::Button("Save")) {
+            if (save_network_conditions((FS_ROOT / network_conditions_path).string(), conditions)) {
+                Logger::instance().info("Saved network conditions to {}", network_conditions_path);
+            }
+        }
+        ImGui::TreePop();
+    }
+    if (changed) network->SetConditions(conditions);
+    if (ImGui::Button("Drop connections")) {
+        Logger::instance().info("Dropping {} simulated connections", network->Sockets());
+        network->DropConnections();
+    }
+    ImGui::Text("Simulated: %zu sockets, %zu in flight, %zu delayed, %zu dropped, %zu reordered", network->Sockets(),
+                network->InFlight(), network->Delayed(), network->Dropped(), network->Reordered());
+    if (recorder != nullptr) {
+        ImGui::Text("Recording: %zu events, %.1f KB", recorder->Records(),
+                    static_cast<double>(recorder->Bytes()) / 1024);
+    }
+    if (replay != nullptr) {
+        ImGui::Text("Replaying: %zu delivered, %zu left, %zu sent", replay->Delivered(), replay->Remaining(),
+                    replay->Sent());
+        float speed = replay->Speed();
+        if (ImGui::SliderFloat("Replay speed (0 = no waiting)", &speed, 0.0f, 16.0f, "%.2fx")) {
+            replay->SetSpeed(speed);
+        }
+    }
+    ImGui::Separator();
+}
+
 void MainMenuContext::EnterMainMenu() {
     state = State::Menu;
     if (user_opt) {
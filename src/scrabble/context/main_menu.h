@@ -1,7 +1,12 @@
 #pragma once
 
+#include <memory>
+
 #include "types.h"
 #include "game_object/game_object.h"
+#include "util/network/connection_manager.h"
+#include "util/network/network_simulator.h"
+#include "util/network/socket_capture.h"
 
 struct ImFont;
 
@@ -25,6 +30,16 @@ namespace scrabble {
 
         MultiplayerContext *multiplayer_context;
 
+        std::shared_ptr<NetworkSimulator> network; // Under every socket; before api, which it outlives
+
+        std::shared_ptr<SocketRecorder> recorder; // Null unless recording
+
+        std::shared_ptr<CaptureReplay> replay; // Null unless replaying
+
+        ConnectionManager::SocketFactory make_socket; // Every socket the game opens comes from here
+
+        std::unique_ptr<ConnectionManager> api; // Login and game creation; completions run in Update
+
         bool* show_debug_window;
 
         float loading_counter{0};
@@ -45,6 +60,11 @@ namespace scrabble {
 
         void RenderMainMenu();
 
+        /**
+         * Network simulator controls, for the debug window.
+         */
+        void RenderNetworkDebug();
+
         void EnterMainMenu();
     };
 }
@@ -1,7 +1,11 @@
 #include "multiplayer.h"
 
+#include <array>
 #include <iostream>
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <future>
 
 #include "imgui.h"
 #include "imgui_stdlib.h"
@@ -18,14 +22,27 @@
 #include "scrabble/sprites/tile.h"
 #include "types_inspector.h"
 #include "game_object/tween/tween.h"
+#include "scrabble/actions/anagram_index.h"
+#include "scrabble/actions/apply_actions.h"
+#include "scrabble/actions/claim_search.h"
+#include "scrabble/actions/game_handles.h"
 #include "scrabble/actions/legal_actions.h"
+#include "scrabble/actions/word_cursor.h"
+#include "scrabble/dictionary/dawg.h"
+#include "scrabble/protocol/action_encoder.h"
+#include "scrabble/protocol/game_delta.h"
+#include "scrabble/protocol/game_message_decoder.h"
+#include "scrabble/protocol/game_session.h"
+#include "util/filesystem/filesystem.h"
 #include "util/queue.h"
-#include "util/network/sockets/web_socket.h"
+#include "util/thread_pool/work_stealing_pool.h"
 
 using namespace scrabble;
 
 namespace {
-    WebSocketImpl *game_socket{nullptr};
+    std::unique_ptr<GameSession> game_session_; // The game socket, reconnected as needed
+
+    GameSession::Status session_status_{GameSession::Status::Connecting}; // As last logged
 
     std::optional<MultiplayerGame> game_opt{std::nullopt};
 
@@ -45,6 +62,118 @@ namespace {
 
     std::optional<GameStateUpdate> last_action_;
 
+    std::optional<int> applied_hash_; // hashCode of game_opt, acknowledged in POLLs to get deltas
+
+    bool want_full_snapshot_{false}; // A delta didn't apply; stop acknowledging until a snapshot arrives
+
+    GameInterner interner_; // Tile and word ids of the current game
+
+    HandleTable handles_; // Positions in game_opt
+
+    HandleTable old_handles_; // Positions in the snapshot before game_opt
+
+    std::vector<TileProps> old_tiles_; // Tiles of the snapshot before game_opt, for animating what changed
+
+    std::vector<StealCandidate> steal_candidates_; // Scratch for SendWord
+
+    WordCursor word_cursor_; // Live status of the word being typed
+
+    std::future<std::shared_ptr<const AnagramIndex> > anagram_index_future_;
+
+    bool show_hints_{false};
+
+    bool hints_stale_{true}; // Board changed since the last search started
+
+    ClaimSearchResult hint_;
+
+    constexpr auto HINT_SEARCH_BUDGET = std::chrono::milliseconds(250);
+
+    // Debug toggle, off by default: binary frames save bandwidth, but they skip the JSON prescan
+    // and the streaming decoder, so they cost the client more CPU. Takes effect on the next game
+    // socket; servers without MessagePack answer in JSON either way.
+    bool request_msgpack_{false};
+
+    ActionEncoder encoder_;
+
+    std::array<GameMessage, 16> inbox_;
+
+    /**
+     * One of our FLIPs or CLAIMs, shown before the server has confirmed it.
+     */
+    struct Prediction {
+        GameStateUpdate action;
+        std::string word_id; // CLAIM from the pool: the new word's id until the server names it
+        size_t baseline{0}; // CLAIM: words spelling claimWord the player had when it was sent
+        std::chrono::steady_clock::time_point sent_at; // Restamped when a reconnect sends it for real
+    };
+
+    std::deque<Prediction> predictions_; // Oldest first
+
+    std::optional<MultiplayerGame> confirmed_game_; // Last server snapshot, while predictions_ isn't empty
+
+    bool shown_predicted_{false}; // game_opt has predictions applied, so the pool isn't at any server hash
+
+    size_t next_predicted_word_{0};
+
+    size_t predictions_confirmed_{0};
+
+    size_t predictions_rolled_back_{0};
+
+    // Sending to the first snapshot showing it, over the latest 256
+    LatencyRecorder prediction_confirm_times_ = LatencyRecorder::Window(256);
+
+    // Long enough for a polled round trip on a bad connection. A CLAIM that lost the buzz to
+    // someone else is only ever taken back this way. Doesn't run while the socket is down and the
+    // action is still waiting to go out.
+    constexpr auto PREDICTION_TIMEOUT = std::chrono::seconds(2);
+
+    // How long the server lets a buzz run before it lapses, for the countdown
+    constexpr double BUZZ_TIME_MS = 5000;
+
+    std::optional<int> buzz_holder_; // As of the last snapshot, to tell a new buzz from one we've seen
+
+    double buzz_started_{0}; // On the server's clock, epoch ms
+
+    /**
+     * Dates the buzz in game on the server's clock. With serverTime, buzzElapsed is exact as of
+     * it; without, a new buzz is taken to be half a round trip older than its arrival.
+     */
+    void track_buzz(const MultiplayerGame &game, const ReplyTiming &timing, const ClockSync &clock) {
+        if (!game.buzzHolder.has_value()) {
+            buzz_holder_.reset();
+            return;
+        }
+        const bool new_buzz = game.buzzHolder != buzz_holder_;
+        buzz_holder_ = game.buzzHolder;
+        const auto elapsed = static_cast<double>(game.buzzElapsed.value_or(0));
+        if (timing.serverTime.has_value()) {
+            buzz_started_ = static_cast<double>(*timing.serverTime) - elapsed;
+        } else if (new_buzz) {
+            buzz_started_ = clock.ToServer(timing.receivedAt) - clock.SmoothedRoundTrip() / 2 - elapsed;
+        }
+    }
+
+    size_t words_spelling(const GameState &state, const int player, const std::string &word) {
+        if (player < 0 || player >= static_cast<int>(state.playerWords.size())) return 0;
+        return std::count_if(state.playerWords[player].begin(), state.playerWords[player].end(),
+                             [&](const Word &w) { return !w.history.empty() && w.history.front() == word; });
+    }
+
+    bool prediction_confirmed(const Prediction &prediction, const GameState &server) {
+        const auto &action = prediction.action;
+        if (action.actionType == "FLIP") {
+            return std::any_of(server.tiles.begin(), server.tiles.end(), [&](const TileProps &tile) {
+                return tile.id == action.flippedTileId && tile.faceUp;
+            });
+        }
+        return words_spelling(server, action.actingPlayer, action.claimWord) > prediction.baseline;
+    }
+
+    bool apply_prediction(GameState &state, const Prediction &prediction) {
+        if (prediction.action.actionType == "FLIP") return apply_flip(state, prediction.action.flippedTileId);
+        return apply_claim(state, prediction.action, prediction.word_id);
+    }
+
     void DrawTiles() {
         const auto texture = Tile::GetTileTexture();
         for (const auto &data: public_tile_draw_data) {
@@ -71,94 +200,6 @@ namespace {
 
     constexpr float DEFAULT_MARGIN = 8.0f;
 
-    std::string start_action(const int player_id) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "START",
-            .action = std::nullopt,
-            .data = ""
-        };
-        return serialize(action);
-    }
-
-    std::string poll_action(const int player_id) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "POLL",
-            .action = std::nullopt,
-            .data = ""
-        };
-        return serialize(action);
-    }
-
-    std::string chat_action(const int player_id, const std::string &message) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "CHAT",
-            .action = std::nullopt,
-            .data = message
-        };
-        return serialize(action);
-    }
-
-    std::string buzz_action(const int player_id) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "BUZZ",
-            .action = std::nullopt,
-            .data = ""
-        };
-        return serialize(action);
-    }
-
-    std::string end_action(const int player_id) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "END",
-            .action = std::nullopt,
-            .data = ""
-        };
-        return serialize(action);
-    }
-
-    std::string flip_action(const int player_id, const int user_index, const std::string &tile_id) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "ACTION",
-            .action = GameStateUpdate{
-                .actionType = "FLIP",
-                .flippedTileId = tile_id,
-                .claimWord = "",
-                .stolenWordId = "",
-                .actingPlayer = user_index,
-                .stolenPlayer = std::nullopt
-            },
-            .data = ""
-        };
-        return serialize(action);
-    }
-
-    std::string claim_action(const int player_id,
-                             const int user_index,
-                             const std::optional<int> stolen_user_index,
-                             const std::string &stolen_word_id,
-                             const std::string &claim_word) {
-        const auto action = MultiplayerAction{
-            .playerId = player_id,
-            .actionType = "ACTION",
-            .action = GameStateUpdate{
-                .actionType = "CLAIM",
-                .flippedTileId = "",
-                .claimWord = claim_word,
-                .stolenWordId = stolen_word_id,
-                .actingPlayer = user_index,
-                .stolenPlayer = stolen_user_index
-            },
-            .data = ""
-        };
-        return serialize(action);
-    }
-
     FlowContainer *horizontal_flow() {
         using namespace frameflow;
         return new FlowContainer(FlowData{
@@ -188,6 +229,10 @@ namespace {
 
 MultiplayerContext::MultiplayerContext() {
     using namespace frameflow;
+    game_decoder = std::make_unique<GameMessageDecoder>(recv_game_queue);
+    solver_pool = std::make_unique<WorkStealingPool>();
+    claim_search = std::make_unique<ClaimSearch>(*solver_pool);
+
     canvas = new LayoutSystem();
     canvas->Hide();
     AddChild(canvas);
@@ -255,79 +300,275 @@ MultiplayerContext::MultiplayerContext() {
 }
 
 MultiplayerContext::~MultiplayerContext() {
-    if (game_socket) {
-        game_socket->close();
-        delete game_socket;
-        game_socket = nullptr;
-    }
+    game_session_.reset();
 }
 
 void MultiplayerContext::Update(const float delta_time) {
     switch (state) {
         case State::PreInit:
             return;
-        case State::Gateway: {
-            // join or create
-            std::string msg;
-            while (recv_create_queue.try_dequeue(msg)) {
-                Logger::instance().info("{}", msg);
-                if (auto response = deserialize<MultiplayerActionResponse>(msg); response.ok) {
-                    Logger::instance().info("New game created");
-                    EnterLobby(response.game->id);
-                } else {
-                    Logger::instance().error("{}", response.errorMessage);
-                }
-            }
-            /*
-            while (recv_join_queue.try_dequeue(msg)) {
-            }
-            */
+        case State::Gateway:
+            // Join or create responses arrive through HandleCreateResult
             return;
-        }
         default: break;
     }
 
     // State is Playing or Lobby
+    encoder_.SetFormat(game_decoder->BinarySeen() ? WireFormat::MessagePack : WireFormat::Json);
+    game_session_->Update(delta_time);
+    if (const auto status = game_session_->CurrentStatus(); status != session_status_) {
+        if (status == GameSession::Status::Open) {
+            Logger::instance().info("Multiplayer game socket connected");
+        } else if (status == GameSession::Status::WaitingToReconnect) {
+            Logger::instance().warn("Game socket closed ({}), retrying in {:.2f} s (attempt {})",
+                                    game_session_->LastError(), game_session_->RetryIn(),
+                                    game_session_->Attempt() + 1);
+        }
+        session_status_ = status;
+    }
+    if (game_session_->TakeReconnected()) {
+        Logger::instance().info("Game socket back after {:.2f} s, resyncing from hash {}",
+                                game_session_->LastReconnectTime(), applied_hash_.value_or(0));
+        // POLLs sent before the drop will never be answered. One POLL acknowledging the last
+        // applied hash brings us up to date, as a delta if the server can.
+        poll_scheduler.Reset();
+        if (state == State::Playing) {
+            game_session_->Send(encoder_.Subscribe(), encoder_.Format(), GameSession::SendClass::Control);
+        }
+        SendPoll();
+        // Actions taken while disconnected only just went out; their predictions get the full timeout
+        const auto now = std::chrono::steady_clock::now();
+        for (auto &prediction: predictions_) {
+            prediction.sent_at = now;
+        }
+    }
     if (state == State::Playing) {
         PollGameEvents();
     }
-    time_since_last_poll += delta_time;
-    if (time_since_last_poll > 0.100) {
-        assert(game_socket != nullptr);
-        game_socket->send(poll_action(main_menu->user_opt->id));
-        time_since_last_poll = 0;
-    }
-    std::string msg;
-    while (recv_game_queue.try_dequeue(msg)) {
-        if (auto response = deserialize<MultiplayerActionResponse>(msg); response.ok) {
-            if (!game_opt.has_value()) {
-                auto it = std::find(
-                    response.game->playerIds.begin(),
-                    response.game->playerIds.end(),
-                    main_menu->user_opt->id);
-                user_index_ = std::distance(response.game->playerIds.begin(), it);
-                game_opt = response.game;
-                Logger::instance().info("Entering playing state with user index {}", user_index_);
-                EnterPlaying();
-                RedrawGame();
+    poll_scheduler.SetLobby(state == State::Lobby);
+    poll_scheduler.SetBuzzing(game_opt.has_value() && game_opt->buzzHolder.has_value());
+    if (poll_scheduler.Tick(delta_time)) {
+        SendPoll();
+    }
+    // In batches of up to 16, dequeued in one go
+    size_t received;
+    while ((received = recv_game_queue.try_dequeue_bulk(inbox_.begin(), inbox_.size())) > 0) {
+        for (size_t i = 0; i < received; i++) {
+            auto &msg = inbox_[i];
+            if (const auto *error = std::get_if<ProtocolError>(&msg)) {
+                Logger::instance().error("Bad game message ({}): {}", error->what, error->excerpt);
+                poll_scheduler.OnResponse(false, false);
+                continue;
             }
-            if (response.game->phase == "CREATED") {
-                state = State::Lobby;
-            } else if (response.game->phase == "ONGOING") {
-                state = State::Playing;
-            } else if (response.game->phase == "FINISHED") {
-                state = State::Playing;
+            const auto &timing = *reply_timing(msg);
+            server_clock.AddReply(timing);
+            if (const auto *skipped = std::get_if<SkippedResponse>(&msg)) {
+                poll_scheduler.OnResponse(skipped->pushed, false);
+                continue;
             }
-            auto old_game = *game_opt;
-            game_opt = response.game;
-            if (response.game->lastAction != last_action_) {
-                Logger::instance().info("Received a new action");
-                last_action_ = response.game->lastAction;
-                HandleAction(old_game, *response.game);
+            if (const auto *delta = std::get_if<GameDeltaResponse>(&msg)) {
+                poll_scheduler.OnResponse(delta->pushed, delta->ok && delta->hashCode != applied_hash_);
+                if (!delta->ok) {
+                    Logger::instance().error("{}", delta->errorMessage);
+                    continue;
+                }
+                // Deltas against a snapshot we've moved past are answers to older POLLs, or pushes
+                // after one we missed. The next POLL acknowledges the current hash and gets a delta
+                // we can use; with push on that could be a keepalive away, so ask now.
+                if (!game_opt.has_value() || delta->delta.baseHash != applied_hash_) {
+                    poll_scheduler.PollNow();
+                    continue;
+                }
+                // In place, on the server's game under any predictions; only the tiles a shown
+                // game had are kept, to animate what changed
+                auto &base = confirmed_game_.has_value() ? *confirmed_game_ : *game_opt;
+                if (!confirmed_game_.has_value()) old_tiles_ = game_opt->state.tiles;
+                if (!apply_game_delta(base, delta->delta)) {
+                    Logger::instance().warn("Game delta did not apply, requesting a full snapshot");
+                    want_full_snapshot_ = true;
+                    poll_scheduler.PollNow();
+                    continue;
+                }
+                ApplyGameDelta(delta->hashCode);
+                track_buzz(*game_opt, timing, server_clock);
+                continue;
             }
+            auto &response = std::get<MultiplayerActionResponse>(msg);
+            poll_scheduler.OnResponse(response.pushed, response.ok && response.hashCode != applied_hash_);
+            if (response.ok) {
+                want_full_snapshot_ = false;
+                ApplyGameState(std::move(*response.game), response.hashCode, std::move(response.skippedActions));
+                track_buzz(*game_opt, timing, server_clock);
+            } else {
+                Logger::instance().error("{}", response.errorMessage);
+            }
+        }
+    }
+
+    if (!predictions_.empty() && session_status_ == GameSession::Status::Open &&
+        std::chrono::steady_clock::now() - predictions_.front().sent_at > PREDICTION_TIMEOUT) {
+        Reconcile(*applied_hash_);
+    }
+
+    if (anagram_index_future_.valid() &&
+        anagram_index_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        anagram_index = anagram_index_future_.get();
+        hints_stale_ = true;
+    }
+    if (show_hints_ && hints_stale_ && state == State::Playing && anagram_index && game_opt.has_value()) {
+        claim_search->Start(game_opt->state, anagram_index, HINT_SEARCH_BUDGET);
+        hints_stale_ = false;
+    }
+    claim_search->TakeResult(hint_);
+    game_session_->Flush();
+}
+
+void MultiplayerContext::ApplyGameState(MultiplayerGame game, const int hash_code,
+                                        std::vector<GameStateUpdate> skipped_actions) {
+    intern_handles(game, interner_);
+    for (auto &action: skipped_actions) {
+        intern_handles(action, interner_);
+    }
+    applied_hash_ = hash_code;
+    if (predictions_.empty()) {
+        ShowGameState(std::move(game), hash_code, std::move(skipped_actions), false);
+        return;
+    }
+    confirmed_game_ = std::move(game);
+    Reconcile(hash_code, std::move(skipped_actions));
+}
+
+void MultiplayerContext::ApplyGameDelta(const int hash_code) {
+    applied_hash_ = hash_code;
+    if (predictions_.empty()) {
+        intern_handles(*game_opt, interner_);
+        ShowCurrentGame(hash_code, {}, false);
+        return;
+    }
+    intern_handles(*confirmed_game_, interner_);
+    Reconcile(hash_code);
+}
+
+void MultiplayerContext::Reconcile(const int hash_code, std::vector<GameStateUpdate> skipped_actions) {
+    assert(confirmed_game_.has_value());
+    auto shown = *confirmed_game_;
+    const auto now = std::chrono::steady_clock::now();
+    bool rolled_back = false;
+    std::erase_if(predictions_, [&](const Prediction &prediction) {
+        if (prediction_confirmed(prediction, confirmed_game_->state)) {
+            predictions_confirmed_++;
+            prediction_confirm_times_.Record(now - prediction.sent_at);
+            return true;
+        }
+        // Not in yet: still shown, unless it's been too long or the board moved under it
+        if (now - prediction.sent_at <= PREDICTION_TIMEOUT && apply_prediction(shown.state, prediction)) return false;
+        Logger::instance().info("Taking back predicted {} {}{}", prediction.action.actionType,
+                                prediction.action.flippedTileId, prediction.action.claimWord);
+        predictions_rolled_back_++;
+        rolled_back = true;
+        return true;
+    });
+    if (predictions_.empty()) confirmed_game_.reset();
+    intern_handles(shown, interner_);
+    ShowGameState(std::move(shown), predictions_.empty() ? std::optional(hash_code) : std::nullopt,
+                  std::move(skipped_actions), rolled_back);
+}
+
+void MultiplayerContext::PredictAction(const GameStateUpdate &action) {
+    if (!game_opt.has_value() || game_opt->phase != "ONGOING") return;
+    Prediction prediction{action, "", 0, std::chrono::steady_clock::now()};
+    if (action.actionType == "CLAIM") {
+        if (action.stolenWordId.empty()) prediction.word_id = "predicted-" + std::to_string(next_predicted_word_++);
+        prediction.baseline = words_spelling(game_opt->state, action.actingPlayer, action.claimWord);
+    }
+    auto shown = *game_opt;
+    if (!apply_prediction(shown.state, prediction)) return;
+    if (predictions_.empty()) confirmed_game_ = *game_opt;
+    predictions_.push_back(std::move(prediction));
+    shown.lastAction = action;
+    intern_handles(shown, interner_);
+    ShowGameState(std::move(shown), std::nullopt, {}, false);
+}
+
+void MultiplayerContext::ShowGameState(MultiplayerGame game, const std::optional<int> hash_code,
+                                       std::vector<GameStateUpdate> skipped_actions, const bool rolled_back) {
+    if (!game_opt.has_value()) {
+        auto it = std::find(
+            game.playerIds.begin(),
+            game.playerIds.end(),
+            main_menu->user_opt->id);
+        user_index_ = std::distance(game.playerIds.begin(), it);
+        game_opt = game;
+        handles_.Rebuild(game_opt->state, interner_);
+        Logger::instance().info("Entering playing state with user index {}", user_index_);
+        // Servers that support it push every change from now on; PollScheduler notices either way
+        game_session_->Send(encoder_.Subscribe(), encoder_.Format(), GameSession::SendClass::Control);
+        EnterPlaying();
+        RedrawGame();
+    }
+    old_tiles_ = std::move(game_opt->state.tiles);
+    game_opt = std::move(game);
+    ShowCurrentGame(hash_code, std::move(skipped_actions), rolled_back);
+}
+
+void MultiplayerContext::ShowCurrentGame(const std::optional<int> hash_code,
+                                         const std::vector<GameStateUpdate> &skipped_actions, const bool rolled_back) {
+    // A board with predictions in it, or coming back from one, isn't at any hash the pool knows
+    const bool hash_changed = !hash_code.has_value() || shown_predicted_ || tile_pool.HashCode() != hash_code;
+    shown_predicted_ = !hash_code.has_value();
+    if (hash_changed) {
+        // Whatever the running search finds is about a board that no longer exists
+        claim_search->Cancel();
+        hints_stale_ = true;
+    }
+    if (game_opt->phase == "CREATED") {
+        state = State::Lobby;
+    } else if (game_opt->phase == "ONGOING") {
+        state = State::Playing;
+    } else if (game_opt->phase == "FINISHED") {
+        state = State::Playing;
+    }
+    std::swap(old_handles_, handles_);
+    handles_.Rebuild(game_opt->state, interner_);
+    if (game_opt->state.dictionary != dictionary_name) {
+        LoadDictionary(game_opt->state.dictionary);
+    }
+    // Actions from responses the decoder coalesced away. Flips animate one by one; claims are
+    // diffed against the whole old board, so only the last one needs handling.
+    const GameStateUpdate *last_claim = nullptr;
+    for (const auto &action: skipped_actions) {
+        if (action.actionType == "FLIP") {
+            HandleFlipAction(old_tiles_, *game_opt, action);
+        } else if (action.actionType == "CLAIM") {
+            last_claim = &action;
+        }
+    }
+    if (game_opt->lastAction != last_action_) {
+        Logger::instance().info("Received a new action");
+        last_action_ = game_opt->lastAction;
+        if (game_opt->lastAction->actionType == "CLAIM") last_claim = nullptr;
+        HandleAction(old_tiles_, *game_opt);
+    }
+    if (last_claim != nullptr) {
+        HandleClaimAction(old_tiles_, *game_opt, *last_claim);
+    }
+    if (hash_changed) {
+        // Flips and claims were applied incrementally in HandleAction. If they don't account
+        // for the new pool (missed intermediate actions, first snapshot, predictions taken
+        // back), recount. The check is a full pass over the tiles, but an index that still
+        // matches keeps its version, so nothing derived from it goes stale.
+        const int pool_hash = hash_code.value_or(*applied_hash_);
+        const auto pool = public_histogram(game_opt->state);
+        if (!rolled_back && tile_pool.HashCode().has_value() && tile_pool.Letters() == pool) {
+            tile_pool.SetHashCode(pool_hash);
         } else {
-            Logger::instance().error("{}", response.errorMessage);
+            tile_pool.Rebuild(pool, pool_hash);
         }
+        // Same for claimed words; only players whose words actually differ get re-indexed.
+        steal_index.Sync(game_opt->state);
+    }
+    if (rolled_back) {
+        RedrawGame(); // Snap back; nothing animates a tile turning face down again
     }
 }
 
@@ -363,6 +604,8 @@ void MultiplayerContext::Draw() {
     }
     ImGui::End();
     DrawTiles();
+    // What the UI sent this frame: words, chat, START/END
+    if (game_session_ != nullptr) game_session_->Flush();
 }
 
 /**
@@ -416,8 +659,8 @@ void MultiplayerContext::RedrawGame() const {
         for (auto *child: flow->GetChildren()) {
             child->Delete();
         }
-        for (const auto &[history, id]: game_opt->state.playerWords[player_index]) {
-            const auto &word = history.front();
+        for (const auto &claimed: game_opt->state.playerWords[player_index]) {
+            const auto &word = claimed.history.front();
             auto *word_margin = margin_all(DEFAULT_MARGIN * 2.0f);
             flow->AddChild(word_margin);
             word_margin->GetNode()->minimum_size = {
@@ -454,9 +697,8 @@ void MultiplayerContext::RedrawGame() const {
 void MultiplayerContext::RenderGateway() {
     ImGui::Begin("Multiplayer Gateway");
     if (ImGui::Button("New Game")) {
-        // do new game socket thread
-        std::thread t(NewGameSocket, std::ref(recv_create_queue), main_menu->user_opt->token);
-        t.detach();
+        request_new_game(*main_menu->api, main_menu->user_opt->token,
+                         [this](const ConnectionManager::Result &result) { HandleCreateResult(result); });
     }
     static std::string foo;
     ImGui::InputText("Game ID or URL", &foo);
@@ -472,7 +714,7 @@ void MultiplayerContext::RenderGateway() {
 
 void MultiplayerContext::RenderChat() const {
     if (!game_opt) return;
-    assert(game_socket != nullptr);
+    assert(game_session_ != nullptr);
 
     ImGui::Begin("Chat", nullptr, ImGuiWindowFlags_NoScrollbar);
     ImGui::PushFont(main_menu->monospace_font);
@@ -488,9 +730,19 @@ void MultiplayerContext::RenderChat() const {
                           ImVec2(0, -reservedHeight), // Reserve space for separator + input
                           ImGuiChildFlags_Borders);
 
+        // Ages on the server's clock, which stamped the messages, so a wrong local clock doesn't matter
+        const double now = server_clock.ServerNow();
         for (const auto &msg: game_opt->chat) {
             // Timestamp
-            ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "[%s]", msg.timestamp.c_str());
+            if (const auto sent = parse_utc_timestamp(msg.timestamp)) {
+                const auto age_s = static_cast<long>(std::max(0.0, now - static_cast<double>(*sent)) / 1000);
+                if (age_s < 60) ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "[%lds ago]", age_s);
+                else if (age_s < 3600) ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "[%ldm ago]", age_s / 60);
+                else ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "[%ldh ago]", age_s / 3600);
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", msg.timestamp.c_str());
+            } else {
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "[%s]", msg.timestamp.c_str());
+            }
             ImGui::SameLine();
 
             // Sender
@@ -536,7 +788,7 @@ void MultiplayerContext::RenderChat() const {
 
     // Send message when Enter is pressed (without Ctrl)
     if (enterPressed && !inputBuffer.empty()) {
-        game_socket->send(chat_action(main_menu->user_opt->id, inputBuffer));
+        SendAction(encoder_.Chat(inputBuffer), GameSession::SendClass::Chat);
         inputBuffer.clear();
         setFocus = true; // Retain focus
     }
@@ -545,16 +797,81 @@ void MultiplayerContext::RenderChat() const {
     ImGui::End();
 }
 
+void MultiplayerContext::RenderDebug() {
+    if (state == State::PreInit || state == State::Gateway) return;
+    auto &round_trips = poll_scheduler.RoundTrips();
+    const float interval_ms = poll_scheduler.Interval() * 1000.0f;
+    const double rtt = round_trips.Percentile(50);
+    // Polling: half a round trip plus, on average, half an interval before the poll goes out
+    const double expected = poll_scheduler.PushActive() ? rtt / 2 : rtt / 2 + interval_ms / 2;
+    ImGui::Text("Game sync: %s, polling every %.0f ms, %s", to_string(poll_scheduler.CurrentMode()), interval_ms,
+                game_decoder->BinarySeen() ? "MessagePack" : "JSON");
+    ImGui::Checkbox("Ask for MessagePack on the next game socket", &request_msgpack_);
+    ImGui::Text("Polls %zu, pushes %zu, last change %.1f s ago", poll_scheduler.PollsSent(), poll_scheduler.Pushes(),
+                poll_scheduler.SinceLastChange());
+    ImGui::Text("Poll round trip p50 %.1f p95 %.1f max %.1f ms", rtt, round_trips.Percentile(95),
+                round_trips.Percentile(100));
+    ImGui::Text("Expected update latency %.0f ms", expected);
+    if (server_clock.Synced()) {
+        // Offset() is against our monotonic clock; against the wall clock it means something
+        const auto now = local_millis();
+        const double wall_offset = server_clock.Offset() - static_cast<double>(wall_millis() - now);
+        ImGui::Text("Server clock %+.1f ms from ours, +/- %.1f ms (%zu samples)", wall_offset,
+                    server_clock.ErrorBound(now), server_clock.Samples());
+        ImGui::Text("Game socket round trip min %.1f smoothed %.1f +/- %.1f ms", server_clock.MinRoundTrip(),
+                    server_clock.SmoothedRoundTrip(), server_clock.RoundTripVariation());
+    } else {
+        ImGui::Text("Server clock: not synced (no serverTime in POLL replies)");
+    }
+    ImGui::Text("Last decode %ld us (%zu decoded, %zu skipped, %zu errors)", game_decoder->LastDecodeMicros(),
+                game_decoder->DecodedCount(), game_decoder->SkippedCount(), game_decoder->ErrorCount());
+    const auto &buffers = game_decoder->Buffers();
+    ImGui::Text("Receive buffers: %zu allocated, %zu reused, %zu idle", buffers.Allocated(), buffers.Reused(),
+                buffers.Idle());
+    auto &reconnects = game_session_->ReconnectTimes();
+    ImGui::Text("Game socket %s, %zu drops, %zu reconnects (p50 %.0f max %.0f ms), last resync %zu B",
+                to_string(game_session_->CurrentStatus()), game_session_->Drops(), game_session_->Reconnects(),
+                reconnects.Percentile(50), reconnects.Percentile(100), game_session_->LastResyncBytes());
+    ImGui::Text("Actions waiting for the connection: %zu (%zu discarded)", game_session_->Unsent(),
+                game_session_->DiscardedActions());
+    ImGui::Text("Sends by class (queued to written, p50/max ms), %zu POLLs coalesced:",
+                game_session_->CoalescedPolls());
+    for (size_t i = 0; i < GameSession::SEND_CLASSES; i++) {
+        const auto send_class = static_cast<GameSession::SendClass>(i);
+        auto &latency = game_session_->SendLatency(send_class);
+        ImGui::Text("  %-8s %6zu  %.2f / %.2f", to_string(send_class), game_session_->Sent(send_class),
+                    latency.Percentile(50), latency.Percentile(100));
+    }
+    ImGui::Text("API connections: %zu handshakes, %zu requests reused one", main_menu->api->Connects(),
+                main_menu->api->Reuses());
+    ImGui::Text("Predictions: %zu pending, %zu confirmed (p50 %.0f p95 %.0f ms), %zu taken back", predictions_.size(),
+                predictions_confirmed_, prediction_confirm_times_.Percentile(50),
+                prediction_confirm_times_.Percentile(95), predictions_rolled_back_);
+    ImGui::Separator();
+}
+
 void MultiplayerContext::RenderLobby() const {
-    assert(game_socket != nullptr);
+    assert(game_session_ != nullptr);
     if (ImGui::Button("Start Game")) {
-        game_socket->send(start_action(main_menu->user_opt->id));
+        SendAction(encoder_.Start(), GameSession::SendClass::Control);
     }
 }
 
-void MultiplayerContext::RenderPlaying() const {
+void MultiplayerContext::RenderPlaying() {
     assert(game_opt.has_value());
-    assert(game_socket != nullptr);
+    assert(game_session_ != nullptr);
+    if (game_session_->CurrentStatus() == GameSession::Status::WaitingToReconnect) {
+        ImGui::Text("Connection lost, reconnecting in %.1f s", game_session_->RetryIn());
+    } else if (game_session_->CurrentStatus() == GameSession::Status::Connecting) {
+        ImGui::Text("Reconnecting...");
+    }
+    if (const auto holder = game_opt->buzzHolder) {
+        const auto &names = game_opt->playerNames;
+        const bool known = *holder >= 0 && *holder < static_cast<int>(names.size());
+        const char *who = *holder == static_cast<int>(user_index_) ? "You" : known ? names[*holder].c_str() : "Someone";
+        const double left_ms = std::max(0.0, BUZZ_TIME_MS - (server_clock.ServerNow() - buzz_started_));
+        ImGui::Text("%s buzzed, %.1f s left", who, left_ms / 1000);
+    }
     static std::string word_input;
     if (want_word_input_focus_) {
         ImGui::SetKeyboardFocusHere();
@@ -586,17 +903,78 @@ void MultiplayerContext::RenderPlaying() const {
 
     ImGui::PopFont();
     ImGui::PopStyleVar();
+
+    // Only the characters that changed since last frame are fed through the cursor
+    word_cursor_.Track(tile_pool, steal_index, dictionary, game_opt->state.wordMinimumSize);
+    word_cursor_.SyncTo(word_input);
+    switch (word_cursor_.Status()) {
+        case WordFeasibility::Empty:
+            ImGui::TextDisabled(" ");
+            break;
+        case WordFeasibility::NotAWord:
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Not a word");
+            break;
+        case WordFeasibility::Impossible:
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Impossible");
+            break;
+        case WordFeasibility::Incomplete:
+            ImGui::TextDisabled("...");
+            break;
+        case WordFeasibility::FromPool:
+            ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Claimable from pool");
+            break;
+        case WordFeasibility::Steal: {
+            const auto steal = *word_cursor_.BestSteal();
+            const char *owner = steal.player < static_cast<int>(game_opt->playerNames.size())
+                                    ? game_opt->playerNames[steal.player].c_str()
+                                    : "?";
+            ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Steals %s from %s",
+                               steal.word->history.front().c_str(), owner);
+            break;
+        }
+    }
+    if (anagram_index) {
+        ImGui::Checkbox("Hints", &show_hints_);
+        if (show_hints_) {
+            if (claim_search->Running()) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("searching...");
+            } else if (!hint_.claims.empty()) {
+                const auto &best = hint_.claims.front();
+                ImGui::SameLine();
+                ImGui::Text("%.*s%s (%zu claims, %.1f ms%s)", static_cast<int>(best.word.size()), best.word.data(),
+                            best.stolen ? " by stealing" : "", hint_.claims.size(), hint_.elapsed_ms,
+                            hint_.complete ? "" : ", cut short");
+            }
+        }
+    }
     if (game_opt->phase == "ONGOING") {
         if (ImGui::Button("End Game")) {
-            game_socket->send(end_action(main_menu->user_opt->id));
+            SendAction(encoder_.End(), GameSession::SendClass::Control);
         }
     }
     ImGui::Text("%s", game_opt->phase.c_str());
     InspectStruct("game", *game_opt);
 }
 
+void MultiplayerContext::HandleCreateResult(const ConnectionManager::Result &result) {
+    if (state != State::Gateway) return; // Left the gateway meanwhile
+    if (!result.Ok()) {
+        Logger::instance().error("New game request failed: {}", result.message);
+        return;
+    }
+    Logger::instance().info("{}", result.message);
+    if (auto response = deserialize<MultiplayerActionResponse>(result.message); response.ok) {
+        Logger::instance().info("New game created");
+        EnterLobby(response.game->id);
+    } else {
+        Logger::instance().error("{}", response.errorMessage);
+    }
+}
+
 void MultiplayerContext::EnterGateway() {
     state = State::Gateway;
+    main_menu->api->Warm(create_game_path);
     main_menu->login_context->AttemptTokenAuth(main_menu->user_opt->token);
     // re authenticate in parallel?
     // re authenticate every X seconds?
@@ -608,16 +986,20 @@ void MultiplayerContext::EnterGateway() {
 void MultiplayerContext::EnterLobby(const std::string &game_id) {
     Logger::instance().info("Entering game lobby: {}", game_id);
     state = State::Lobby;
-    if (game_socket != nullptr) {
+    if (game_session_ != nullptr) {
         Logger::instance().info("Closing and resetting socket");
-        game_socket->close();
-        delete game_socket;
-        game_socket = nullptr;
+        game_session_.reset();
     }
-    game_socket = create_multiplayer_game_socket(&recv_game_queue,
-                                                 main_menu->user_opt->token,
-                                                 game_id);
-    time_since_last_poll = 0;
+    game_decoder->Reset(); // Before the new socket can deliver anything
+    encoder_.SetPlayer(main_menu->user_opt->id);
+    encoder_.SetFormat(WireFormat::Json);
+    game_session_ = create_multiplayer_game_session(game_decoder.get(),
+                                                    main_menu->user_opt->token,
+                                                    game_id,
+                                                    request_msgpack_ ? WireFormat::MessagePack : WireFormat::Json,
+                                                    main_menu->make_socket);
+    session_status_ = game_session_->CurrentStatus();
+    poll_scheduler.Reset();
 }
 
 void MultiplayerContext::EnterPlaying() {
@@ -626,17 +1008,77 @@ void MultiplayerContext::EnterPlaying() {
 }
 
 void MultiplayerContext::ExitMultiplayer() {
-    if (game_socket != nullptr) {
-        game_socket->close();
-        delete game_socket;
-        game_socket = nullptr;
-    }
+    game_session_.reset();
     game_opt = std::nullopt;
     state = State::PreInit;
     last_action_ = std::nullopt;
+    applied_hash_ = std::nullopt;
+    want_full_snapshot_ = false;
+    predictions_.clear();
+    confirmed_game_ = std::nullopt;
+    shown_predicted_ = false;
+    buzz_holder_.reset();
+    server_clock.Reset();
+    game_decoder->Reset();
+    interner_.Clear();
+    handles_.Clear();
+    old_handles_.Clear();
+    old_tiles_.clear();
+    tile_pool.Clear();
+    steal_index.Clear();
+    claim_search->Cancel();
+    hint_ = {};
+    hints_stale_ = true;
 }
 
-void MultiplayerContext::PollGameEvents() const {
+/**
+ * Maps assets/dictionaries/<name>.dawg (built with dict-build). Without one, every claim is
+ * sent and the server is the only judge of what is a word.
+ */
+void MultiplayerContext::LoadDictionary(const std::string &name) {
+    dictionary_name = name;
+    dictionary.reset();
+    anagram_index.reset();
+    anagram_index_future_ = {};
+    claim_search->Cancel();
+    hint_ = {};
+    if (name.empty()) return;
+    const bool safe_name = std::all_of(name.begin(), name.end(), [](const unsigned char c) {
+        return std::isalnum(c) || c == '_' || c == '-';
+    });
+    if (!safe_name) {
+        Logger::instance().warn("Ignoring dictionary with unexpected name: {}", name);
+        return;
+    }
+    const auto path = FS_ROOT / "assets" / "dictionaries" / (name + ".dawg");
+    const auto start = std::chrono::steady_clock::now();
+    auto loaded = std::make_shared<Dictionary>();
+    if (!loaded->Open(path.string())) {
+        Logger::instance().warn("No local dictionary for {}, claims will only be checked by the server", name);
+        return;
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    Logger::instance().info("Loaded dictionary {} ({} words, {} bytes) in {:.2f} ms",
+                            name, loaded->WordCount(), loaded->ByteSize(), elapsed.count());
+    dictionary = std::move(loaded);
+
+    // Grouping ~200k words by signature takes a few frames' worth of time, so keep it off the main thread
+    auto build = std::make_shared<std::packaged_task<std::shared_ptr<const AnagramIndex>()> >(
+        [words = dictionary, name] {
+            const auto build_start = std::chrono::steady_clock::now();
+            auto index = std::make_shared<AnagramIndex>();
+            index->Build(*words);
+            const auto build_elapsed = std::chrono::steady_clock::now() - build_start;
+            Logger::instance().info("Built anagram index for {} ({} classes) in {:.2f} ms", name,
+                                    index->Classes().size(),
+                                    std::chrono::duration<double, std::milli>(build_elapsed).count());
+            return std::shared_ptr<const AnagramIndex>(std::move(index));
+        });
+    anagram_index_future_ = build->get_future();
+    solver_pool->Submit([build](size_t) { (*build)(); });
+}
+
+void MultiplayerContext::PollGameEvents() {
     const bool want_mouse = ImGui::GetIO().WantCaptureMouse;
     const bool left_mouse_down = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
     const auto mouse_position = GetMousePosition();
@@ -649,7 +1091,8 @@ void MultiplayerContext::PollGameEvents() const {
             data.dimensions.y
         };
         const bool is_over_rect = CheckCollisionPointRec(mouse_position, rect);
-        if (!want_mouse && left_mouse_down && is_over_rect) {
+        // Draw data lags the board until a claim's animation ends
+        if (!want_mouse && left_mouse_down && is_over_rect && i < static_cast<int>(game_opt->state.tiles.size())) {
             auto &tile_props = game_opt->state.tiles[i];
             FlipTile(tile_props.id);
         }
@@ -669,71 +1112,91 @@ void MultiplayerContext::PollGameEvents() const {
     }
 }
 
-void MultiplayerContext::SendWord(const std::string &word) const {
-    Logger::instance().info("Sending word: {}", word);
+void MultiplayerContext::SendAction(const std::string &message, const GameSession::SendClass send_class) const {
+    assert(game_session_ != nullptr);
+    game_session_->SendOrQueue(message, encoder_.Format(), send_class);
+}
 
-    game_socket->send(buzz_action(main_menu->user_opt->id));
-
-    for (int i = 0; i < game_opt->state.playerCount; i++) {
-        for (auto &steal_candidate: game_opt->state.playerWords[i]) {
-            if (can_steal_word(word, steal_candidate, game_opt->state)) {
-                game_socket->send(claim_action(main_menu->user_opt->id,
-                                               static_cast<int>(user_index_),
-                                               i,
-                                               steal_candidate.id,
-                                               word
-                ));
-                return;
-            }
-        }
+void MultiplayerContext::SendPoll() const {
+    assert(game_session_ != nullptr);
+    // Servers without delta support ignore POLL data and keep sending snapshots
+    const bool want_delta = applied_hash_.has_value() && !want_full_snapshot_;
+    game_session_->Send(encoder_.Poll(want_delta ? applied_hash_ : std::nullopt, local_millis()), encoder_.Format(),
+                        GameSession::SendClass::Poll);
+}
+
+void MultiplayerContext::SendWord(const std::string &word) {
+    if (dictionary && !dictionary->Contains(word)) {
+        Logger::instance().info("Not sending {}: not in {}", word, dictionary_name);
+        return;
     }
 
-    // try to steal from public
-    game_socket->send(claim_action(main_menu->user_opt->id,
-                                   static_cast<int>(user_index_),
-                                   std::nullopt,
-                                   "",
-                                   word));
+    Logger::instance().info("Sending word: {}", word);
+
+    SendAction(encoder_.Buzz(), GameSession::SendClass::Claim);
+
+    GameStateUpdate claim{"CLAIM", "", word, "", static_cast<int>(user_index_), std::nullopt};
+    const auto word_letters = LetterHistogram::FromWord(word);
+    steal_candidates_.clear();
+    steal_index.Query(word, word_letters, tile_pool.Letters(), steal_candidates_);
+    if (!steal_candidates_.empty()) {
+        // Ranked, so the first candidate is the longest steal
+        const auto &best = steal_candidates_.front();
+        SendAction(encoder_.Claim(static_cast<int>(user_index_), best.player, best.word->id, word),
+                   GameSession::SendClass::Claim);
+        claim.stolenWordId = best.word->id;
+        claim.stolenPlayer = best.player;
+    } else {
+        // try to steal from public
+        SendAction(encoder_.Claim(static_cast<int>(user_index_), std::nullopt, "", word),
+                   GameSession::SendClass::Claim);
+    }
+    // Someone else holding the buzz means the server will turn this down
+    if (!game_opt->buzzHolder.has_value() || *game_opt->buzzHolder == static_cast<int>(user_index_)) {
+        PredictAction(claim);
+    }
 }
 
-void MultiplayerContext::FlipTile(const std::string &tile_id) const {
+void MultiplayerContext::FlipTile(const std::string &tile_id) {
     Logger::instance().info("Sending flip: {}", tile_id);
-    game_socket->send(flip_action(main_menu->user_opt->id,
-                                  static_cast<int>(user_index_),
-                                  tile_id));
+    SendAction(encoder_.Flip(static_cast<int>(user_index_), tile_id), GameSession::SendClass::Flip);
+    PredictAction(GameStateUpdate{"FLIP", tile_id, "", "", static_cast<int>(user_index_), std::nullopt});
 }
 
-void MultiplayerContext::HandleAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state) {
+void MultiplayerContext::HandleAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state) {
     if (new_state.lastAction->actionType == "FLIP") {
-        HandleFlipAction(old_state, new_state, *new_state.lastAction);
+        HandleFlipAction(old_tiles, new_state, *new_state.lastAction);
     } else if (new_state.lastAction->actionType == "CLAIM") {
-        HandleClaimAction(old_state, new_state, *new_state.lastAction);
+        HandleClaimAction(old_tiles, new_state, *new_state.lastAction);
     }
 }
 
-void MultiplayerContext::HandleFlipAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state,
+void MultiplayerContext::HandleFlipAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state,
                                           const GameStateUpdate &action) {
     Logger::instance().info("Received flip action");
-    for (int i = 0; i < old_state.state.tiles.size(); i++) {
-        if (action.flippedTileId == old_state.state.tiles[i].id) {
-            const auto tween = TweenManager::instance().CreateTween(
-                &public_tile_draw_data[i].rotation, 360, 0.25f, Easing::EaseInOutSine
-            );
-            tween->SetOnComplete([this] {
-                this->RedrawGame();
-            });
-            break;
-        }
+    const int i = old_handles_.TileIndex(action.flippedTileHandle);
+    if (i < 0 || i >= static_cast<int>(public_tile_draw_data.size())) return;
+    if (old_tiles[i].faceUp) return; // Already turned, by our own prediction
+    const int new_index = handles_.TileIndex(action.flippedTileHandle);
+    if (new_index >= 0) {
+        tile_pool.Flip(new_state.state.tiles[new_index].letter.front());
     }
+    const auto tween = TweenManager::instance().CreateTween(
+        &public_tile_draw_data[i].rotation, 360, 0.25f, Easing::EaseInOutSine
+    );
+    tween->SetOnComplete([this] {
+        this->RedrawGame();
+    });
 }
 
-void MultiplayerContext::HandleClaimAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state,
+void MultiplayerContext::HandleClaimAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state,
                                            const GameStateUpdate &action) {
     Logger::instance().info("Received claim action");
 
     int i = 0;
-    for (auto &t: old_state.state.tiles) {
-        if (get_tile_by_id(t.id, new_state.state) == std::nullopt) {
+    for (auto &t: old_tiles) {
+        if (handles_.TileIndex(t.handle) < 0) {
+            if (t.faceUp) tile_pool.Remove(t.letter.front());
             TweenManager::instance().CreateTween(
                 &public_tile_draw_data[i].position.x, 0, 4, Easing::EaseInOutSine
             );
@@ -744,6 +1207,11 @@ void MultiplayerContext::HandleClaimAction(const MultiplayerGame &old_state, con
         i++;
     }
 
+    steal_index.RebuildPlayer(new_state.state, action.actingPlayer);
+    if (action.stolenPlayer && *action.stolenPlayer != action.actingPlayer) {
+        steal_index.RebuildPlayer(new_state.state, *action.stolenPlayer);
+    }
+
     static float foo = 0;
     TweenManager::instance().CreateTween(
         &foo, 0, 4
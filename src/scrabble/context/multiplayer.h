@@ -1,7 +1,20 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "game_object/game_object.h"
-#include "util/queue.h"
+#include "scrabble/actions/steal_index.h"
+#include "scrabble/actions/tile_pool_index.h"
+#include "scrabble/protocol/clock_sync.h"
+#include "scrabble/protocol/game_message.h"
+#include "scrabble/protocol/game_session.h"
+#include "scrabble/protocol/poll_scheduler.h"
+#include "util/network/connection_manager.h"
+
+class WorkStealingPool;
 
 struct BoxContainer;
 
@@ -16,6 +29,14 @@ struct MarginContainer;
 namespace scrabble {
     struct MainMenuContext;
 
+    class Dictionary;
+
+    class AnagramIndex;
+
+    class ClaimSearch;
+
+    class GameMessageDecoder;
+
     struct MultiplayerGame;
 
     struct GameStateUpdate;
@@ -42,12 +63,27 @@ namespace scrabble {
     public:
         MainMenuContext *main_menu{nullptr};
 
-        Queue recv_create_queue; // Can we combine both of these? Not sure why not...
-        //Queue recv_join_queue;
+        GameMessageQueue recv_game_queue; // Active game, already decoded
+
+        std::unique_ptr<GameMessageDecoder> game_decoder; // Feeds recv_game_queue from the game socket
+
+        PollScheduler poll_scheduler;
+
+        ClockSync server_clock; // The server's time, estimated from POLL round trips
+
+        TilePoolIndex tile_pool; // Face-up letters of the current game
 
-        Queue recv_game_queue; // Active game
+        StealIndex steal_index; // Claimed words of the current game
 
-        float time_since_last_poll{0};
+        std::shared_ptr<const Dictionary> dictionary; // Local copy of GameState::dictionary, if we ship one
+
+        std::string dictionary_name;
+
+        std::unique_ptr<WorkStealingPool> solver_pool;
+
+        std::unique_ptr<ClaimSearch> claim_search; // Background hint search, restarted on every flip or claim
+
+        std::shared_ptr<const AnagramIndex> anagram_index; // Built from dictionary on solver_pool
 
         bool should_redraw_layout{false};
 
@@ -71,7 +107,17 @@ namespace scrabble {
 
         void RenderLobby() const;
 
-        void RenderPlaying() const;
+        void RenderPlaying();
+
+        /**
+         * Connection stats for the debug window.
+         */
+        void RenderDebug();
+
+        /**
+         * Completion of a create game request; enters its lobby if we're still in the gateway.
+         */
+        void HandleCreateResult(const ConnectionManager::Result &result);
 
         void EnterGateway();
 
@@ -81,18 +127,71 @@ namespace scrabble {
 
         void ExitMultiplayer();
 
-        void PollGameEvents() const;
-
-        void SendWord(const std::string &word) const;
-
-        void FlipTile(const std::string &tile_id) const;
-
-        void HandleAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state);
-
-        void HandleFlipAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state,
+        /**
+         * Makes game the current snapshot, from a full response or an applied delta. Predicted
+         * actions the server hasn't confirmed yet are replayed on top of it.
+         */
+        void ApplyGameState(MultiplayerGame game, int hash_code, std::vector<GameStateUpdate> skipped_actions = {});
+
+        /**
+         * ApplyGameState for a delta already applied in place, to confirmed_game_ while there are
+         * predictions and to game_opt otherwise, in which case old_tiles_ holds its tiles from before.
+         */
+        void ApplyGameDelta(int hash_code);
+
+        /**
+         * Shows the confirmed snapshot with the predictions still pending applied on top; those
+         * that are confirmed, no longer apply or have waited too long are dropped.
+         */
+        void Reconcile(int hash_code, std::vector<GameStateUpdate> skipped_actions = {});
+
+        /**
+         * Puts game on screen: animates its last action, updates the pool and steal indexes.
+         * hash_code is empty for a game with local predictions in it. rolled_back redraws right
+         * away, for predictions taken back.
+         */
+        void ShowGameState(MultiplayerGame game, std::optional<int> hash_code,
+                           std::vector<GameStateUpdate> skipped_actions, bool rolled_back);
+
+        /**
+         * ShowGameState once game_opt holds the new game and old_tiles_ the tiles it replaced.
+         */
+        void ShowCurrentGame(std::optional<int> hash_code, const std::vector<GameStateUpdate> &skipped_actions,
+                             bool rolled_back);
+
+        /**
+         * Applies one of our own FLIPs or CLAIMs locally as soon as it's sent, if it's legal on
+         * the board we're showing.
+         */
+        void PredictAction(const GameStateUpdate &action);
+
+        void LoadDictionary(const std::string &name);
+
+        void PollGameEvents();
+
+        /**
+         * Sends a message from the ActionEncoder: a binary frame in MessagePack mode, text otherwise.
+         * While the game socket is reconnecting, the message waits for the new connection.
+         * send_class decides what it may overtake in the outbound queue.
+         */
+        void SendAction(const std::string &message, GameSession::SendClass send_class) const;
+
+        /**
+         * POLL acknowledging the last applied hashCode, unless a full snapshot is wanted. Dropped
+         * while disconnected.
+         */
+        void SendPoll() const;
+
+        void SendWord(const std::string &word);
+
+        void FlipTile(const std::string &tile_id);
+
+        void HandleAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state);
+
+        void HandleFlipAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state,
                               const GameStateUpdate &action);
 
-        void HandleClaimAction(const MultiplayerGame &old_state, const MultiplayerGame &new_state,
+        void HandleClaimAction(const std::vector<TileProps> &old_tiles, const MultiplayerGame &new_state,
                                const GameStateUpdate &action);
 
         // exit playing?
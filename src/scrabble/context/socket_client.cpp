@@ -1,99 +1,97 @@
 #include "socket_client.h"
 
+#include <cstdlib>
+#include <utility>
+
 #include "types.h"
+#include "util/filesystem/filesystem.h"
 #include "util/logging/logging.h"
 
 namespace scrabble {
-    void UserLoginSocket(Queue &recvLoginQueue, const std::string &username, const std::string &password) {
-        const std::string url = "wss://api.playpiratescrabble.com/ws/account/login";
-
-        const auto payload = serialize(UserLoginAttempt{username, password});
-
-        const WebSocket::Ptr ws = std::make_shared<WebSocket>(url);
-
-        ws->on_open = [ws, payload] {
-            ws->send(payload);
-        };
-        ws->on_message = [&recvLoginQueue](const std::string &msg) {
-            recvLoginQueue.enqueue(msg);
-        };
-        ws->on_error = [](const std::string &err) {
-            Logger::instance().error("Credential auth socket error: {}", err);
-        };
-        ws->on_close = []() {
-        };
-
-        ws->connect();
-
-        // todo refactor to not use thread
-        std::this_thread::sleep_for(std::chrono::seconds(4));
+    namespace {
+        /**
+         * PIRATE_SCRABBLE_API overrides the production host, e.g. ws://127.0.0.1:8080/ws/ for
+         * pirate-scrabble-server.
+         */
+        const std::string &api_base_url() {
+            static const std::string url = [] {
+                const char *override_url = std::getenv("PIRATE_SCRABBLE_API");
+                return std::string(override_url != nullptr && *override_url != '\0'
+                                       ? override_url
+                                       : "wss://api.playpiratescrabble.com/ws/");
+            }();
+            return url;
+        }
+
+        WebSocketImpl::Ptr make_web_socket(const std::string &url) {
+            return std::make_shared<WebSocket>(url);
+        }
     }
 
-    void TokenAuthSocket(Queue &recvLoginQueue, const std::string &token) {
-        const std::string url = "wss://api.playpiratescrabble.com/ws/account/tokenAuth";
-        const WebSocket::Ptr ws = std::make_shared<WebSocket>(url);
-
-        ws->on_open = [ws, token] {
-            ws->send(token);
-        };
-        ws->on_message = [&recvLoginQueue](const std::string &msg) {
-            recvLoginQueue.enqueue(msg);
-        };
-        ws->on_error = [](const std::string &err) {
-            Logger::instance().error("Token auth socket error: {}", err);
-        };
-        ws->on_close = []() {
-        };
-
-        ws->connect();
-
-        // todo refactor to not use thread
-        std::this_thread::sleep_for(std::chrono::seconds(4));
+    std::shared_ptr<NetworkSimulator> create_network_simulator() {
+        NetworkConditions conditions;
+        if (fs::exists(FS_ROOT / network_conditions_path)) {
+            if (load_network_conditions((FS_ROOT / network_conditions_path).string(), conditions)) {
+                Logger::instance().info("Network conditions from {} ({})", network_conditions_path,
+                                        conditions.enabled ? "enabled" : "disabled");
+            } else {
+                Logger::instance().warn("Ignoring unreadable {}", network_conditions_path);
+            }
+        }
+        return std::make_shared<NetworkSimulator>(conditions);
     }
 
-    void NewGameSocket(Queue &recvLoginQueue, const std::string &token) {
-        const std::string url = "wss://api.playpiratescrabble.com/ws/multiplayer/create";
-        const WebSocket::Ptr ws = std::make_shared<WebSocket>(url);
+    std::shared_ptr<SocketRecorder> create_socket_recorder() {
+        const char *path = std::getenv("PIRATE_SCRABBLE_RECORD");
+        if (path == nullptr || *path == '\0') return nullptr;
+        auto recorder = SocketRecorder::Open(path);
+        if (recorder == nullptr) Logger::instance().error("Can't record sockets to {}", path);
+        else Logger::instance().info("Recording sockets to {}", path);
+        return recorder;
+    }
 
-        ws->on_open = [ws, token] {
-            ws->send(token);
-        };
-        ws->on_message = [&recvLoginQueue](const std::string &msg) {
-            recvLoginQueue.enqueue(msg);
-        };
-        ws->on_error = [](const std::string &err) {
-            Logger::instance().error("New game socket error: {}", err);
-        };
-        ws->on_close = []() {
-        };
+    std::shared_ptr<CaptureReplay> create_capture_replay() {
+        const char *path = std::getenv("PIRATE_SCRABBLE_REPLAY");
+        if (path == nullptr || *path == '\0') return nullptr;
+        const char *speed = std::getenv("PIRATE_SCRABBLE_REPLAY_SPEED");
+        auto replay = CaptureReplay::Load(path, speed != nullptr ? std::strtof(speed, nullptr) : 1.0f);
+        if (replay == nullptr) {
+            Logger::instance().error("Can't read capture {}, connecting for real", path);
+        } else {
+            Logger::instance().info("Replaying {} ({} messages) at {}x", path, replay->RecordedMessages(),
+                                    replay->Speed());
+        }
+        return replay;
+    }
 
-        ws->connect();
+    ConnectionManager::SocketFactory create_socket_factory(const std::shared_ptr<NetworkSimulator> &network,
+                                                           const std::shared_ptr<SocketRecorder> &recorder,
+                                                           const std::shared_ptr<CaptureReplay> &replay) {
+        auto make_socket = network->Factory(replay != nullptr ? replay->Factory() : make_web_socket);
+        return recorder != nullptr ? recorder->Factory(std::move(make_socket)) : make_socket;
+    }
 
-        // todo refactor to not use thread
-        std::this_thread::sleep_for(std::chrono::seconds(4));
+    std::unique_ptr<ConnectionManager> create_api_connections(ConnectionManager::SocketFactory make_socket) {
+        return std::make_unique<ConnectionManager>(api_base_url(), std::move(make_socket));
     }
 
-    WebSocketImpl *create_multiplayer_game_socket(Queue *recvLoginQueue, const std::string &token,
-                                                  const std::string &game_id) {
-        const std::string url = "wss://api.playpiratescrabble.com/ws/multiplayer/v2/" + game_id;
-        auto *ws = new WebSocket(url);
+    void request_user_login(ConnectionManager &api, const std::string &username, const std::string &password,
+                            ConnectionManager::Callback done) {
+        api.Request(login_path, serialize(UserLoginAttempt{username, password}), std::move(done));
+    }
 
-        ws->on_open = [ws, token]() {
-            Logger::instance().info("Multiplayer game socket connected");
-            ws->send(token);
-        };
-        ws->on_message = [recvLoginQueue](const std::string &msg) {
-            recvLoginQueue->enqueue(msg);
-        };
-        ws->on_error = [](const std::string &err) {
-            Logger::instance().error("Multiplayer game socket error: {}", err);
-        };
-        ws->on_close = []() {
-            Logger::instance().info("Multiplayer game socket closed");
-        };
+    void request_token_auth(ConnectionManager &api, const std::string &token, ConnectionManager::Callback done) {
+        api.Request(token_auth_path, token, std::move(done));
+    }
 
-        ws->connect();
+    void request_new_game(ConnectionManager &api, const std::string &token, ConnectionManager::Callback done) {
+        api.Request(create_game_path, token, std::move(done));
+    }
 
-        return ws;
+    std::unique_ptr<GameSession> create_multiplayer_game_session(GameMessageDecoder *decoder, const std::string &token,
+                                                                 const std::string &game_id, const WireFormat wire,
+                                                                 GameSession::SocketFactory make_socket) {
+        return std::make_unique<GameSession>(api_base_url() + "multiplayer/v2/" + game_id + wire_query(wire), token,
+                                             decoder, std::move(make_socket));
     }
 }
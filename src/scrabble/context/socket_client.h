@@ -1,8 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
-#include "util/queue.h"
+#include "scrabble/protocol/game_session.h"
+#include "scrabble/protocol/wire_format.h"
+#include "util/network/connection_manager.h"
+#include "util/network/network_simulator.h"
+#include "util/network/socket_capture.h"
 #include "util/network/sockets/web_socket.h"
 
 #ifdef __EMSCRIPTEN__
@@ -14,13 +19,68 @@ using WebSocket = WebSocketDesktop;
 #endif
 
 namespace scrabble {
-    void UserLoginSocket(Queue &recvLoginQueue, const std::string &username, const std::string &password);
+    class GameMessageDecoder;
 
-    void TokenAuthSocket(Queue &recvLoginQueue, const std::string &token);
+    inline const std::string network_conditions_path = "network_conditions.json";
 
-    void NewGameSocket(Queue &recvLoginQueue, const std::string &token);
+    /**
+     * Starts from network_conditions_path if there is one, otherwise off. Every socket the game
+     * opens goes through it, so the debug window can change conditions mid-game.
+     */
+    std::shared_ptr<NetworkSimulator> create_network_simulator();
 
-    //void JoinGameSocket(Queue &recvLoginQueue, std::string token);
+    /**
+     * Records every socket to the file PIRATE_SCRABBLE_RECORD names; null if it's unset.
+     */
+    std::shared_ptr<SocketRecorder> create_socket_recorder();
 
-    WebSocketImpl* create_multiplayer_game_socket(Queue *recvLoginQueue, const std::string& token, const std::string &game_id);
+    /**
+     * Replays the capture PIRATE_SCRABBLE_REPLAY names instead of connecting, at
+     * PIRATE_SCRABBLE_REPLAY_SPEED times the original pace (default 1, 0 for no waiting); null if
+     * it's unset.
+     */
+    std::shared_ptr<CaptureReplay> create_capture_replay();
+
+    /**
+     * Real sockets, or replay's if there is one, behind network. recorder (if any) sees what the
+     * game sees, simulated conditions included.
+     */
+    ConnectionManager::SocketFactory create_socket_factory(const std::shared_ptr<NetworkSimulator> &network,
+                                                           const std::shared_ptr<SocketRecorder> &recorder,
+                                                           const std::shared_ptr<CaptureReplay> &replay);
+
+    /**
+     * The API host's request/response endpoints; paths below are relative to it.
+     */
+    std::unique_ptr<ConnectionManager> create_api_connections(ConnectionManager::SocketFactory make_socket);
+
+    inline const std::string login_path = "account/login";
+
+    inline const std::string token_auth_path = "account/tokenAuth";
+
+    inline const std::string create_game_path = "multiplayer/create";
+
+    /**
+     * Replies with a UserResponse.
+     */
+    void request_user_login(ConnectionManager &api, const std::string &username, const std::string &password,
+                            ConnectionManager::Callback done);
+
+    /**
+     * Replies with a UserResponse.
+     */
+    void request_token_auth(ConnectionManager &api, const std::string &token, ConnectionManager::Callback done);
+
+    /**
+     * Replies with a MultiplayerActionResponse for the new game.
+     */
+    void request_new_game(ConnectionManager &api, const std::string &token, ConnectionManager::Callback done);
+
+    /**
+     * Messages are handed to decoder undecoded; it must outlive the session. wire is only a
+     * request, see WireFormat.
+     */
+    std::unique_ptr<GameSession> create_multiplayer_game_session(GameMessageDecoder *decoder, const std::string &token,
+                                                                 const std::string &game_id, WireFormat wire,
+                                                                 GameSession::SocketFactory make_socket);
 }
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <optional>
 
 #include "util/serialization/serialization.h"
+#include "util/serialization/stream_decode.h"
 
 namespace scrabble {
     struct PersistentData {
@@ -25,16 +27,18 @@ namespace scrabble {
         std::string letter;
         std::string id;
         bool faceUp;
+        int handle{-1}; // Interned id, not serialized (see game_handles.h)
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(TileProps, letter, id, faceUp)
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(TileProps, letter, id, faceUp)
 
     struct Word {
         std::vector<std::string> history;
         std::string id;
+        int handle{-1}; // Interned id, not serialized
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Word, history, id)
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(Word, history, id)
 
     struct GameState {
         int tileCount;
@@ -45,7 +49,7 @@ namespace scrabble {
         std::vector<std::vector<Word> > playerWords;
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         GameState,
         tileCount,
         wordMinimumSize,
@@ -62,12 +66,17 @@ namespace scrabble {
         std::string stolenWordId;
         int actingPlayer;
         std::optional<int> stolenPlayer;
-
-        bool operator==(const GameStateUpdate&) const = default;
-        bool operator!=(const GameStateUpdate&) const = default;
+        int flippedTileHandle{-1}; // Interned id, not serialized
+
+        // Wire fields only; the handle depends on which interner saw the update
+        bool operator==(const GameStateUpdate &other) const {
+            return actionType == other.actionType && flippedTileId == other.flippedTileId &&
+                   claimWord == other.claimWord && stolenWordId == other.stolenWordId &&
+                   actingPlayer == other.actingPlayer && stolenPlayer == other.stolenPlayer;
+        }
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         GameStateUpdate,
         actionType,
         flippedTileId,
@@ -83,7 +92,7 @@ namespace scrabble {
         std::string message;
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         MultiplayerChatMessage,
         sender,
         timestamp,
@@ -97,7 +106,7 @@ namespace scrabble {
         std::string data;
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         MultiplayerAction,
         playerId,
         actionType,
@@ -112,12 +121,12 @@ namespace scrabble {
         std::vector<int> playerIds;
         std::vector<std::string> playerNames;
         std::optional<int> buzzHolder;
-        std::optional<int> buzzElapsed;
+        std::optional<int> buzzElapsed; // Milliseconds, as of the message's serverTime if it has one
         std::optional<GameStateUpdate> lastAction;
         std::vector<MultiplayerChatMessage> chat;
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         MultiplayerGame,
         id,
         phase,
@@ -130,14 +139,29 @@ namespace scrabble {
         chat
     )
 
+    /**
+     * When a game socket message was sent and received, in milliseconds; read from the envelope
+     * and the socket, not serialized. serverTime is the server's epoch time as it sent the
+     * message, pollSent echoes the sent= field of the POLL it answers (see ClockSync), receivedAt
+     * is local_millis() when the frame came off the socket.
+     */
+    struct ReplyTiming {
+        std::optional<std::int64_t> serverTime;
+        std::optional<std::int64_t> pollSent;
+        std::int64_t receivedAt{0};
+    };
+
     struct MultiplayerActionResponse {
         bool ok;
         std::optional<MultiplayerGame> game;
         int hashCode;
         std::string errorMessage;
+        bool pushed{false}; // Sent unprompted by a subscribed server; read from the envelope, not serialized
+        std::vector<GameStateUpdate> skippedActions{}; // From responses the decoder coalesced away, oldest first
+        ReplyTiming timing{};
     };
 
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
         MultiplayerActionResponse,
         ok,
         game,
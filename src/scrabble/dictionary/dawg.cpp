@@ -0,0 +1,94 @@
+#include "dawg.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "scrabble/actions/letter_histogram.h"
+
+using namespace scrabble;
+
+bool Dictionary::Open(const std::string &path) {
+    Close();
+    if (!file_.Open(path)) return false;
+    if (file_.Size() < sizeof(DawgHeader)) {
+        std::cerr << "Dictionary file too small: " << path << "\n";
+        Close();
+        return false;
+    }
+    std::memcpy(&header_, file_.Data(), sizeof(DawgHeader));
+    if (std::memcmp(header_.magic, DAWG_MAGIC, sizeof(DAWG_MAGIC)) != 0 || header_.version != DAWG_VERSION) {
+        std::cerr << "Not a compiled dictionary (wrong magic or version): " << path << "\n";
+        Close();
+        return false;
+    }
+    const size_t expected = sizeof(DawgHeader) + static_cast<size_t>(header_.edge_count) * sizeof(std::uint32_t);
+    if (header_.edge_count == 0 || file_.Size() < expected || header_.root >= header_.edge_count) {
+        std::cerr << "Truncated or corrupt dictionary: " << path << "\n";
+        Close();
+        return false;
+    }
+    // Header is 32 bytes and the mapping is page aligned, so the edge array is 4-byte aligned.
+    edges_ = reinterpret_cast<const std::uint32_t *>(file_.Data() + sizeof(DawgHeader));
+    return true;
+}
+
+void Dictionary::Close() {
+    file_.Close();
+    header_ = {};
+    edges_ = nullptr;
+}
+
+bool Dictionary::Contains(const std::string_view word) const {
+    if (word.empty()) return false;
+    auto cursor = Root();
+    for (const char c: word) {
+        cursor = Step(cursor, c);
+        if (!cursor.valid) return false;
+    }
+    return cursor.terminal;
+}
+
+DawgCursor Dictionary::Root() const {
+    if (!IsOpen()) return {};
+    return {header_.root, false, true};
+}
+
+DawgCursor Dictionary::Step(const DawgCursor cursor, const char letter) const {
+    const int index = letter_index(letter);
+    if (!cursor.valid || cursor.list == 0 || index < 0) return {};
+    for (std::uint32_t i = cursor.list; i < header_.edge_count; i++) {
+        const std::uint32_t edge = edges_[i];
+        if (static_cast<int>(edge & DAWG_LETTER_BITS) == index) {
+            return {edge >> DAWG_CHILD_SHIFT, (edge & DAWG_TERMINAL_BIT) != 0, true};
+        }
+        if (edge & DAWG_LAST_BIT) break;
+    }
+    return {};
+}
+
+void Dictionary::ForEachWord(const std::function<void(std::string_view)> &visit) const {
+    if (!IsOpen()) return;
+    struct Frame {
+        std::uint32_t edge;
+    };
+    std::string prefix;
+    std::vector<Frame> stack;
+    prefix.reserve(header_.max_word_length + 1);
+    stack.reserve(header_.max_word_length + 1);
+    stack.push_back({header_.root});
+    while (!stack.empty()) {
+        auto &frame = stack.back();
+        if (frame.edge == 0 || frame.edge >= header_.edge_count) {
+            stack.pop_back();
+            if (!prefix.empty()) prefix.pop_back();
+            continue;
+        }
+        const std::uint32_t edge = edges_[frame.edge];
+        // Advance this frame before descending, so we come back to the next sibling
+        frame.edge = (edge & DAWG_LAST_BIT) ? 0 : frame.edge + 1;
+        prefix.push_back(static_cast<char>('A' + (edge & DAWG_LETTER_BITS)));
+        if (edge & DAWG_TERMINAL_BIT) visit(prefix);
+        stack.push_back({edge >> DAWG_CHILD_SHIFT});
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "util/filesystem/mapped_file.h"
+
+namespace scrabble {
+    /**
+     * On-disk layout of a compiled word list (see dawg_builder.h), little-endian:
+     *
+     *   DawgHeader
+     *   uint32_t edges[edge_count]
+     *
+     * Each edge packs:
+     *   bits 0-4   letter (0 = 'A')
+     *   bit  5     a word ends at this edge
+     *   bit  6     last edge of its sibling list
+     *   bits 7-31  index of the child's first edge, 0 if the child has no edges
+     *
+     * Edge 0 is a sentinel so that 0 can mean "no children". Equivalent suffixes are shared,
+     * which is what keeps a full tournament word list to a few hundred KB.
+     */
+    struct DawgHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t edge_count;
+        std::uint32_t word_count;
+        std::uint32_t root;
+        std::uint32_t max_word_length;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(DawgHeader) == 32);
+
+    constexpr char DAWG_MAGIC[8] = {'P', 'S', 'D', 'A', 'W', 'G', '0', '1'};
+    constexpr std::uint32_t DAWG_VERSION = 1;
+
+    constexpr std::uint32_t DAWG_LETTER_BITS = 0x1Fu;
+    constexpr std::uint32_t DAWG_TERMINAL_BIT = 1u << 5;
+    constexpr std::uint32_t DAWG_LAST_BIT = 1u << 6;
+    constexpr int DAWG_CHILD_SHIFT = 7;
+    constexpr std::uint32_t DAWG_MAX_EDGES = 1u << (32 - DAWG_CHILD_SHIFT);
+
+    /**
+     * Position in the DAWG after consuming some prefix. Trivially copyable, so callers can
+     * keep a stack of them to step back on backspace.
+     */
+    struct DawgCursor {
+        std::uint32_t list{0}; // First edge of the children of this position, 0 for none
+        bool terminal{false}; // Prefix consumed so far is a word
+        bool valid{false}; // Prefix consumed so far is a prefix of some word
+    };
+
+    /**
+     * Read-only, memory-mapped word list. Loading is a header check; lookups walk the mapped
+     * edges directly without building any nodes.
+     */
+    class Dictionary {
+    public:
+        bool Open(const std::string &path);
+
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return edges_ != nullptr; }
+
+        [[nodiscard]] bool Contains(std::string_view word) const;
+
+        [[nodiscard]] DawgCursor Root() const;
+
+        [[nodiscard]] DawgCursor Step(DawgCursor cursor, char letter) const;
+
+        /**
+         * Calls visit for every word in alphabetical order. The view is only valid during the call.
+         */
+        void ForEachWord(const std::function<void(std::string_view)> &visit) const;
+
+        [[nodiscard]] std::uint32_t WordCount() const { return header_.word_count; }
+
+        [[nodiscard]] std::uint32_t EdgeCount() const { return header_.edge_count; }
+
+        [[nodiscard]] std::uint32_t MaxWordLength() const { return header_.max_word_length; }
+
+        [[nodiscard]] size_t ByteSize() const { return file_.Size(); }
+
+    private:
+        MappedFile file_;
+
+        DawgHeader header_{};
+
+        const std::uint32_t *edges_{nullptr};
+    };
+}
@@ -0,0 +1,204 @@
+#include "dawg_builder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "dawg.h"
+
+using namespace scrabble;
+
+namespace {
+    struct BuildNode {
+        bool terminal{false};
+        std::vector<std::pair<std::uint8_t, std::uint32_t> > edges; // Sorted by letter
+    };
+
+    /**
+     * Daciuk et al. incremental construction for sorted input. Nodes that turn out to be
+     * equivalent to one already registered are left orphaned in nodes_ and never serialized.
+     */
+    class Minimizer {
+    public:
+        Minimizer() {
+            nodes_.emplace_back(); // root
+        }
+
+        void Insert(const std::string &word) {
+            size_t common = 0;
+            while (common < word.size() && common < previous_.size() && word[common] == previous_[common]) {
+                common++;
+            }
+            Minimize(common);
+            std::uint32_t node = unchecked_.empty() ? 0 : unchecked_.back().child;
+            for (size_t i = common; i < word.size(); i++) {
+                const auto child = static_cast<std::uint32_t>(nodes_.size());
+                nodes_.emplace_back();
+                const auto letter = static_cast<std::uint8_t>(word[i] - 'A');
+                nodes_[node].edges.emplace_back(letter, child);
+                unchecked_.push_back({node, child});
+                node = child;
+            }
+            nodes_[node].terminal = true;
+            previous_ = word;
+        }
+
+        const std::vector<BuildNode> &Finish() {
+            Minimize(0);
+            return nodes_;
+        }
+
+    private:
+        struct Unchecked {
+            std::uint32_t parent;
+            std::uint32_t child;
+        };
+
+        void Minimize(const size_t down_to) {
+            while (unchecked_.size() > down_to) {
+                const auto [parent, child] = unchecked_.back();
+                const std::string key = Key(nodes_[child]);
+                if (const auto it = register_.find(key); it != register_.end()) {
+                    nodes_[parent].edges.back().second = it->second;
+                    nodes_[child].edges.clear();
+                } else {
+                    register_.emplace(key, child);
+                }
+                unchecked_.pop_back();
+            }
+        }
+
+        static std::string Key(const BuildNode &node) {
+            std::string key;
+            key.reserve(1 + node.edges.size() * 5);
+            key.push_back(node.terminal ? '1' : '0');
+            for (const auto &[letter, child]: node.edges) {
+                key.push_back(static_cast<char>(letter));
+                key.append(reinterpret_cast<const char *>(&child), sizeof(child));
+            }
+            return key;
+        }
+
+        std::vector<BuildNode> nodes_;
+
+        std::vector<Unchecked> unchecked_;
+
+        std::unordered_map<std::string, std::uint32_t> register_;
+
+        std::string previous_;
+    };
+}
+
+void DawgBuilder::Add(std::string word) {
+    while (!word.empty() && (word.back() == '\r' || word.back() == ' ' || word.back() == '\t')) word.pop_back();
+    if (word.empty()) return;
+    for (auto &c: word) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c < 'A' || c > 'Z') {
+            skipped_++;
+            return;
+        }
+    }
+    words_.push_back(std::move(word));
+}
+
+std::vector<std::string> DawgBuilder::SortedWords() const {
+    auto words = words_;
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+std::vector<unsigned char> DawgBuilder::Build(DawgBuildStats *stats) {
+    std::sort(words_.begin(), words_.end());
+    words_.erase(std::unique(words_.begin(), words_.end()), words_.end());
+
+    Minimizer minimizer;
+    std::uint32_t max_length = 0;
+    for (const auto &word: words_) {
+        minimizer.Insert(word);
+        max_length = std::max(max_length, static_cast<std::uint32_t>(word.size()));
+    }
+    const auto &nodes = minimizer.Finish();
+
+    // Lay out each reachable node's edge list contiguously, root first. Edge 0 is the sentinel.
+    std::vector<std::uint32_t> list_offset(nodes.size(), 0);
+    std::vector<std::uint32_t> order;
+    std::uint32_t next_edge = 1;
+    std::uint32_t node_count = 0;
+    std::vector<std::uint32_t> pending{0};
+    std::vector<bool> seen(nodes.size(), false);
+    seen[0] = true;
+    while (!pending.empty()) {
+        const auto node = pending.back();
+        pending.pop_back();
+        node_count++;
+        if (nodes[node].edges.empty()) continue;
+        list_offset[node] = next_edge;
+        next_edge += static_cast<std::uint32_t>(nodes[node].edges.size());
+        order.push_back(node);
+        for (const auto &[letter, child]: nodes[node].edges) {
+            if (!seen[child]) {
+                seen[child] = true;
+                pending.push_back(child);
+            }
+        }
+    }
+    if (next_edge >= DAWG_MAX_EDGES) {
+        throw std::runtime_error("Word list too large for the dictionary format");
+    }
+
+    std::vector<std::uint32_t> edges(next_edge, 0);
+    for (const auto node: order) {
+        const auto &node_edges = nodes[node].edges;
+        for (size_t i = 0; i < node_edges.size(); i++) {
+            const auto [letter, child] = node_edges[i];
+            std::uint32_t edge = letter;
+            if (nodes[child].terminal) edge |= DAWG_TERMINAL_BIT;
+            if (i + 1 == node_edges.size()) edge |= DAWG_LAST_BIT;
+            edge |= list_offset[child] << DAWG_CHILD_SHIFT;
+            edges[list_offset[node] + i] = edge;
+        }
+    }
+
+    DawgHeader header{};
+    std::memcpy(header.magic, DAWG_MAGIC, sizeof(DAWG_MAGIC));
+    header.version = DAWG_VERSION;
+    header.edge_count = next_edge;
+    header.word_count = static_cast<std::uint32_t>(words_.size());
+    header.root = list_offset[0];
+    header.max_word_length = max_length;
+
+    std::vector<unsigned char> out(sizeof(DawgHeader) + edges.size() * sizeof(std::uint32_t));
+    std::memcpy(out.data(), &header, sizeof(DawgHeader));
+    std::memcpy(out.data() + sizeof(DawgHeader), edges.data(), edges.size() * sizeof(std::uint32_t));
+
+    if (stats) {
+        stats->word_count = header.word_count;
+        stats->skipped_count = skipped_;
+        stats->node_count = node_count;
+        stats->edge_count = next_edge;
+        stats->max_word_length = max_length;
+    }
+    return out;
+}
+
+bool scrabble::read_word_list(const std::string &path, DawgBuilder &builder) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file for reading: " << path << "\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        builder.Add(std::move(line));
+    }
+    if (file.bad()) {
+        std::cerr << "I/O error while reading file: " << path << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace scrabble {
+    struct DawgBuildStats {
+        std::uint32_t word_count{0};
+        std::uint32_t skipped_count{0}; // Lines with characters outside A-Z (after upper-casing)
+        std::uint32_t node_count{0}; // Distinct nodes after suffix sharing
+        std::uint32_t edge_count{0};
+        std::uint32_t max_word_length{0};
+    };
+
+    /**
+     * Compiles a word list into the format read by Dictionary (dawg.h).
+     *
+     * Words are upper-cased, deduplicated and sorted, then inserted with incremental
+     * minimization, so memory stays proportional to the minimized graph rather than the full trie.
+     */
+    class DawgBuilder {
+    public:
+        /**
+         * Queue a word. Anything that isn't A-Z after upper-casing is skipped.
+         */
+        void Add(std::string word);
+
+        /**
+         * The accepted words so far, sorted and deduplicated.
+         */
+        [[nodiscard]] std::vector<std::string> SortedWords() const;
+
+        /**
+         * Build and return the serialized file contents.
+         */
+        std::vector<unsigned char> Build(DawgBuildStats *stats = nullptr);
+
+    private:
+        std::vector<std::string> words_;
+
+        std::uint32_t skipped_{0};
+    };
+
+    /**
+     * Reads one word per line from path. Returns false if the file can't be read.
+     */
+    bool read_word_list(const std::string &path, DawgBuilder &builder);
+}
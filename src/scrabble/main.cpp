@@ -276,7 +276,7 @@ int main() {
     if (std::string token; read_token(token_path, token)) {
         menu_context->login_context->AttemptTokenAuth(token);
     } else {
-        menu_context->login_context->state = LoginContext::State::Active;
+        menu_context->login_context->ShowForm();
         Logger::instance().info("Failed to read token from disk. User must provide credentials");
     }
 
@@ -387,6 +387,8 @@ int main() {
                 ImGui::Text("UpdateRec average: %f ms", perf.update_avg);
                 ImGui::Text("DrawRec average: %f ms", perf.draw_avg);
                 ImGui::Separator();
+                menu_context->multiplayer_context->RenderDebug();
+                menu_context->RenderNetworkDebug();
                 ImGui::Text("Mouse position %f, %f", GetMousePosition().x, GetMousePosition().y);
                 ImGui::Text("Window size %i, %i", GetScreenWidth(), GetScreenHeight());
                 ImGui::Text("Render size %i, %i", GetRenderWidth(), GetRenderHeight());
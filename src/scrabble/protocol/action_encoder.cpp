@@ -0,0 +1,234 @@
+#include "action_encoder.h"
+
+#include <charconv>
+#include <cstdint>
+
+#include "clock_sync.h"
+#include "game_delta.h"
+
+using namespace scrabble;
+
+namespace {
+    /**
+     * GameStateUpdate's fields, as views.
+     */
+    struct UpdateFields {
+        std::string_view action_type;
+        std::string_view flipped_tile_id;
+        std::string_view claim_word;
+        std::string_view stolen_word_id;
+        int acting_player;
+        std::optional<int> stolen_player;
+    };
+
+    // JSON, as nlohmann's dump() writes it: no whitespace, keys in sorted order
+
+    void json_string(std::string &out, const std::string_view value) {
+        constexpr char HEX[] = "0123456789abcdef";
+        out.push_back('"');
+        for (const char c: value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out.push_back(HEX[c >> 4]);
+                        out.push_back(HEX[c & 0xF]);
+                    } else {
+                        out.push_back(c);
+                    }
+            }
+        }
+        out.push_back('"');
+    }
+
+    void json_int(std::string &out, const int value) {
+        char digits[16];
+        const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, end);
+    }
+
+    void json_update(std::string &out, const UpdateFields &update) {
+        out += R"({"actingPlayer":)";
+        json_int(out, update.acting_player);
+        out += R"(,"actionType":)";
+        json_string(out, update.action_type);
+        out += R"(,"claimWord":)";
+        json_string(out, update.claim_word);
+        out += R"(,"flippedTileId":)";
+        json_string(out, update.flipped_tile_id);
+        out += R"(,"stolenPlayer":)";
+        if (update.stolen_player) json_int(out, *update.stolen_player);
+        else out += "null";
+        out += R"(,"stolenWordId":)";
+        json_string(out, update.stolen_word_id);
+        out.push_back('}');
+    }
+
+    void json_message(std::string &out, const int player_id, const std::string_view action_type,
+                      const std::string_view data, const UpdateFields *update) {
+        out += R"({"action":)";
+        if (update) json_update(out, *update);
+        else out += "null";
+        out += R"(,"actionType":)";
+        json_string(out, action_type);
+        out += R"(,"data":)";
+        json_string(out, data);
+        out += R"(,"playerId":)";
+        json_int(out, player_id);
+        out.push_back('}');
+    }
+
+    // MessagePack, as nlohmann's to_msgpack() writes it: smallest encoding for each value
+
+    template<typename T>
+    void msgpack_big_endian(std::string &out, const T value) {
+        for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>(static_cast<std::uint64_t>(value) >> shift & 0xFF));
+        }
+    }
+
+    void msgpack_int(std::string &out, const int value) {
+        if (value >= 0) {
+            if (value < 128) {
+                out.push_back(static_cast<char>(value));
+            } else if (value <= 0xFF) {
+                out.push_back(static_cast<char>(0xCC));
+                msgpack_big_endian(out, static_cast<std::uint8_t>(value));
+            } else if (value <= 0xFFFF) {
+                out.push_back(static_cast<char>(0xCD));
+                msgpack_big_endian(out, static_cast<std::uint16_t>(value));
+            } else {
+                out.push_back(static_cast<char>(0xCE));
+                msgpack_big_endian(out, static_cast<std::uint32_t>(value));
+            }
+        } else if (value >= -32) {
+            out.push_back(static_cast<char>(value));
+        } else if (value >= INT8_MIN) {
+            out.push_back(static_cast<char>(0xD0));
+            msgpack_big_endian(out, static_cast<std::uint8_t>(value));
+        } else if (value >= INT16_MIN) {
+            out.push_back(static_cast<char>(0xD1));
+            msgpack_big_endian(out, static_cast<std::uint16_t>(value));
+        } else {
+            out.push_back(static_cast<char>(0xD2));
+            msgpack_big_endian(out, static_cast<std::uint32_t>(value));
+        }
+    }
+
+    void msgpack_string(std::string &out, const std::string_view value) {
+        const size_t n = value.size();
+        if (n <= 31) {
+            out.push_back(static_cast<char>(0xA0 | n));
+        } else if (n <= 0xFF) {
+            out.push_back(static_cast<char>(0xD9));
+            msgpack_big_endian(out, static_cast<std::uint8_t>(n));
+        } else if (n <= 0xFFFF) {
+            out.push_back(static_cast<char>(0xDA));
+            msgpack_big_endian(out, static_cast<std::uint16_t>(n));
+        } else {
+            out.push_back(static_cast<char>(0xDB));
+            msgpack_big_endian(out, static_cast<std::uint32_t>(n));
+        }
+        out.append(value);
+    }
+
+    constexpr char MSGPACK_NIL = static_cast<char>(0xC0);
+
+    void msgpack_map(std::string &out, const int entries) {
+        out.push_back(static_cast<char>(0x80 | entries)); // fixmap, up to 15
+    }
+
+    void msgpack_update(std::string &out, const UpdateFields &update) {
+        msgpack_map(out, 6);
+        msgpack_string(out, "actingPlayer");
+        msgpack_int(out, update.acting_player);
+        msgpack_string(out, "actionType");
+        msgpack_string(out, update.action_type);
+        msgpack_string(out, "claimWord");
+        msgpack_string(out, update.claim_word);
+        msgpack_string(out, "flippedTileId");
+        msgpack_string(out, update.flipped_tile_id);
+        msgpack_string(out, "stolenPlayer");
+        if (update.stolen_player) msgpack_int(out, *update.stolen_player);
+        else out.push_back(MSGPACK_NIL);
+        msgpack_string(out, "stolenWordId");
+        msgpack_string(out, update.stolen_word_id);
+    }
+
+    void msgpack_message(std::string &out, const int player_id, const std::string_view action_type,
+                         const std::string_view data, const UpdateFields *update) {
+        msgpack_map(out, 4);
+        msgpack_string(out, "action");
+        if (update) msgpack_update(out, *update);
+        else out.push_back(MSGPACK_NIL);
+        msgpack_string(out, "actionType");
+        msgpack_string(out, action_type);
+        msgpack_string(out, "data");
+        msgpack_string(out, data);
+        msgpack_string(out, "playerId");
+        msgpack_int(out, player_id);
+    }
+
+    void write_message(std::string &out, const WireFormat format, const int player_id,
+                       const std::string_view action_type, const std::string_view data,
+                       const UpdateFields *update = nullptr) {
+        out.clear();
+        if (format == WireFormat::MessagePack) {
+            msgpack_message(out, player_id, action_type, data, update);
+        } else {
+            json_message(out, player_id, action_type, data, update);
+        }
+    }
+}
+
+ActionEncoder::ActionEncoder() {
+    buffer_.reserve(256);
+    scratch_.reserve(32);
+    SetPlayer(0);
+}
+
+void ActionEncoder::EncodeFixed(FixedMessage &into, const std::string_view action_type) const {
+    write_message(into.json, WireFormat::Json, player_id_, action_type, "");
+    write_message(into.msgpack, WireFormat::MessagePack, player_id_, action_type, "");
+}
+
+void ActionEncoder::SetPlayer(const int player_id) {
+    player_id_ = player_id;
+    EncodeFixed(start_, "START");
+    EncodeFixed(end_, "END");
+    EncodeFixed(subscribe_, "SUBSCRIBE");
+    EncodeFixed(buzz_, "BUZZ");
+}
+
+const std::string &ActionEncoder::Poll(const std::optional<int> base_hash, const std::int64_t sent_ms) {
+    if (base_hash.has_value()) write_delta_poll_data(scratch_, *base_hash);
+    else scratch_.clear();
+    append_poll_sent(scratch_, sent_ms);
+    write_message(buffer_, format_, player_id_, "POLL", scratch_);
+    return buffer_;
+}
+
+const std::string &ActionEncoder::Chat(const std::string_view message) {
+    write_message(buffer_, format_, player_id_, "CHAT", message);
+    return buffer_;
+}
+
+const std::string &ActionEncoder::Flip(const int user_index, const std::string_view tile_id) {
+    const UpdateFields update{"FLIP", tile_id, "", "", user_index, std::nullopt};
+    write_message(buffer_, format_, player_id_, "ACTION", "", &update);
+    return buffer_;
+}
+
+const std::string &ActionEncoder::Claim(const int user_index, const std::optional<int> stolen_user_index,
+                                        const std::string_view stolen_word_id, const std::string_view claim_word) {
+    const UpdateFields update{"CLAIM", "", claim_word, stolen_word_id, user_index, stolen_user_index};
+    write_message(buffer_, format_, player_id_, "ACTION", "", &update);
+    return buffer_;
+}
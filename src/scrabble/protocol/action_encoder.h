@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "wire_format.h"
+
+namespace scrabble {
+    /**
+     * Writes outbound MultiplayerActions without going through a json DOM. The fixed messages
+     * (START, END, SUBSCRIBE, BUZZ) are encoded once per player in both formats; the
+     * rest are written into one reused buffer. Output is byte for byte what serialize() /
+     * serialize_msgpack() would produce, so servers can't tell the difference.
+     *
+     * Returned references stay valid until the next call. Once the buffer has grown to fit the
+     * longest message, encoding doesn't allocate.
+     */
+    class ActionEncoder {
+    public:
+        ActionEncoder();
+
+        /**
+         * Re-encodes the fixed messages for player_id.
+         */
+        void SetPlayer(int player_id);
+
+        void SetFormat(const WireFormat format) { format_ = format; }
+
+        [[nodiscard]] WireFormat Format() const { return format_; }
+
+        [[nodiscard]] const std::string &Start() const { return Fixed(start_); }
+
+        [[nodiscard]] const std::string &End() const { return Fixed(end_); }
+
+        [[nodiscard]] const std::string &Subscribe() const { return Fixed(subscribe_); }
+
+        [[nodiscard]] const std::string &Buzz() const { return Fixed(buzz_); }
+
+        /**
+         * POLL stamped with sent_ms (see append_poll_sent), and with delta_poll_data(*base_hash)
+         * as well if there is a base_hash.
+         */
+        const std::string &Poll(std::optional<int> base_hash, std::int64_t sent_ms);
+
+        const std::string &Chat(std::string_view message);
+
+        const std::string &Flip(int user_index, std::string_view tile_id);
+
+        const std::string &Claim(int user_index, std::optional<int> stolen_user_index,
+                                 std::string_view stolen_word_id, std::string_view claim_word);
+
+    private:
+        struct FixedMessage {
+            std::string json;
+            std::string msgpack;
+        };
+
+        [[nodiscard]] const std::string &Fixed(const FixedMessage &message) const {
+            return format_ == WireFormat::MessagePack ? message.msgpack : message.json;
+        }
+
+        void EncodeFixed(FixedMessage &into, std::string_view action_type) const;
+
+        int player_id_{0};
+
+        WireFormat format_{WireFormat::Json};
+
+        FixedMessage start_, end_, subscribe_, buzz_;
+
+        std::string buffer_;
+
+        std::string scratch_; // For POLL data
+    };
+}
@@ -0,0 +1,184 @@
+#include "clock_sync.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+using namespace scrabble;
+
+namespace {
+    constexpr std::string_view POLL_SENT_KEY = "sent=";
+
+    // How fast two clocks can wander apart, as a fraction; old samples loosen by this much
+    constexpr double MAX_DRIFT = 100e-6;
+
+    // RFC 6298's gains
+    constexpr double RTT_GAIN = 1.0 / 8;
+    constexpr double VARIATION_GAIN = 1.0 / 4;
+
+    bool read_int(const std::string_view text, const size_t pos, const size_t length, int &out) {
+        if (pos + length > text.size()) return false;
+        const char *first = text.data() + pos;
+        const auto [end, error] = std::from_chars(first, first + length, out);
+        return error == std::errc{} && end == first + length;
+    }
+
+    /**
+     * Days from 1970-01-01 to a proleptic Gregorian date (Howard Hinnant's days_from_civil).
+     */
+    std::int64_t days_from_civil(int year, const unsigned month, const unsigned day) {
+        year -= month <= 2;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const auto year_of_era = static_cast<unsigned>(year - era * 400);
+        const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+    }
+}
+
+std::int64_t scrabble::local_millis() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t scrabble::wall_millis() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void scrabble::append_poll_sent(std::string &data, const std::int64_t sent_ms) {
+    char digits[24];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), sent_ms);
+    if (!data.empty()) data.push_back('&');
+    data.append(POLL_SENT_KEY);
+    data.append(digits, end);
+}
+
+std::optional<std::int64_t> scrabble::parse_poll_sent(const std::string_view data) {
+    size_t start = 0;
+    while (start <= data.size()) {
+        const size_t end = std::min(data.find('&', start), data.size());
+        const auto field = data.substr(start, end - start);
+        if (field.starts_with(POLL_SENT_KEY)) {
+            std::int64_t sent = 0;
+            const char *first = field.data() + POLL_SENT_KEY.size();
+            const char *last = field.data() + field.size();
+            const auto [parsed_end, error] = std::from_chars(first, last, sent);
+            if (error != std::errc{} || parsed_end != last) return std::nullopt;
+            return sent;
+        }
+        start = end + 1;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::int64_t> scrabble::parse_utc_timestamp(const std::string_view timestamp) {
+    // 2024-05-01T12:34:56
+    int year, month, day, hour, minute, second;
+    if (!read_int(timestamp, 0, 4, year) || !read_int(timestamp, 5, 2, month) || !read_int(timestamp, 8, 2, day) ||
+        !read_int(timestamp, 11, 2, hour) || !read_int(timestamp, 14, 2, minute) ||
+        !read_int(timestamp, 17, 2, second)) {
+        return std::nullopt;
+    }
+    if (timestamp[4] != '-' || timestamp[7] != '-' || (timestamp[10] != 'T' && timestamp[10] != ' ') ||
+        timestamp[13] != ':' || timestamp[16] != ':') {
+        return std::nullopt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return std::nullopt;
+    }
+    std::int64_t millis = 0;
+    size_t pos = 19;
+    if (pos < timestamp.size() && timestamp[pos] == '.') {
+        // Up to millisecond precision; further digits are dropped
+        int scale = 100;
+        for (pos++; pos < timestamp.size() && timestamp[pos] >= '0' && timestamp[pos] <= '9'; pos++) {
+            millis += (timestamp[pos] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (pos < timestamp.size() && timestamp[pos] == 'Z') pos++;
+    if (pos != timestamp.size()) return std::nullopt;
+    const auto days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000 + millis;
+}
+
+ClockSync::ClockSync(const size_t window) : window_(std::max<size_t>(window, 1)) {
+    samples_.reserve(window_);
+}
+
+void ClockSync::Reset() {
+    samples_.clear();
+    next_ = 0;
+    total_ = 0;
+    smoothed_rtt_ = 0;
+    rtt_variation_ = 0;
+}
+
+void ClockSync::AddSample(const std::int64_t sent_ms, const std::int64_t server_ms, const std::int64_t received_ms) {
+    if (received_ms < sent_ms) return;
+    const auto round_trip = static_cast<double>(received_ms - sent_ms);
+    const Sample sample{
+        received_ms,
+        static_cast<double>(server_ms) - (static_cast<double>(sent_ms) + static_cast<double>(received_ms)) / 2,
+        round_trip
+    };
+    if (samples_.size() < window_) {
+        samples_.push_back(sample);
+    } else {
+        samples_[next_] = sample;
+        next_ = (next_ + 1) % window_;
+    }
+    if (total_ == 0) {
+        smoothed_rtt_ = round_trip;
+        rtt_variation_ = round_trip / 2;
+    } else {
+        rtt_variation_ += VARIATION_GAIN * (std::abs(smoothed_rtt_ - round_trip) - rtt_variation_);
+        smoothed_rtt_ += RTT_GAIN * (round_trip - smoothed_rtt_);
+    }
+    total_++;
+}
+
+bool ClockSync::AddReply(const ReplyTiming &timing) {
+    if (!timing.serverTime.has_value() || !timing.pollSent.has_value() || timing.receivedAt == 0) return false;
+    AddSample(*timing.pollSent, *timing.serverTime, timing.receivedAt);
+    return true;
+}
+
+const ClockSync::Sample *ClockSync::Best(const std::int64_t now_ms) const {
+    const Sample *best = nullptr;
+    double best_bound = 0;
+    for (const auto &sample: samples_) {
+        const double bound = sample.round_trip / 2 + static_cast<double>(now_ms - sample.received_ms) * MAX_DRIFT;
+        if (best == nullptr || bound < best_bound) {
+            best = &sample;
+            best_bound = bound;
+        }
+    }
+    return best;
+}
+
+double ClockSync::Offset() const {
+    const auto *best = Best(local_millis());
+    return best != nullptr ? best->offset : 0;
+}
+
+double ClockSync::ErrorBound(const std::int64_t now_ms) const {
+    const auto *best = Best(now_ms);
+    if (best == nullptr) return 0;
+    return best->round_trip / 2 + static_cast<double>(now_ms - best->received_ms) * MAX_DRIFT;
+}
+
+double ClockSync::ToServer(const std::int64_t local_ms) const {
+    if (!Synced()) return static_cast<double>(wall_millis() - local_millis() + local_ms);
+    return static_cast<double>(local_ms) + Offset();
+}
+
+double ClockSync::MinRoundTrip() const {
+    double min = 0;
+    for (size_t i = 0; i < samples_.size(); i++) {
+        if (i == 0 || samples_[i].round_trip < min) min = samples_[i].round_trip;
+    }
+    return min;
+}
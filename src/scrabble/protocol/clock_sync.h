@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "scrabble/context/types.h"
+
+namespace scrabble {
+    /**
+     * Milliseconds on the client's monotonic clock, what POLLs are stamped with.
+     */
+    std::int64_t local_millis();
+
+    /**
+     * Milliseconds since the Unix epoch by the client's wall clock.
+     */
+    std::int64_t wall_millis();
+
+    /**
+     * Appends the POLL data field carrying the time it was sent (local_millis()), which a server
+     * that keeps time echoes back as pollSent. Fields are separated by '&'.
+     */
+    void append_poll_sent(std::string &data, std::int64_t sent_ms);
+
+    /**
+     * Reads append_poll_sent's field back out of POLL data; nullopt if it has none.
+     */
+    std::optional<std::int64_t> parse_poll_sent(std::string_view data);
+
+    /**
+     * Milliseconds since the Unix epoch for a UTC "YYYY-MM-DDTHH:MM:SS" timestamp (fractional
+     * seconds and a trailing Z allowed), as the server stamps chat; nullopt for anything else.
+     */
+    std::optional<std::int64_t> parse_utc_timestamp(std::string_view timestamp);
+
+    /**
+     * Estimates the server's clock from POLL round trips, NTP style. Each POLL carries its send
+     * time t0; the reply carries it back along with the server's time ts, and arrives at t3. If
+     * the two legs took equally long, the server's clock was ts at (t0 + t3) / 2, so
+     *
+     *     offset = ts - (t0 + t3) / 2,  good to within (t3 - t0) / 2
+     *
+     * whatever the legs actually took. The estimate used is the sample from the last few with the
+     * tightest bound, after widening older ones for drift, since the quickest round trips are the
+     * ones least hurt by queueing. Round trip time is also smoothed the way TCP does it.
+     */
+    class ClockSync {
+    public:
+        explicit ClockSync(size_t window = 16);
+
+        void Reset();
+
+        /**
+         * One round trip: sent_ms and received_ms by local_millis(), server_ms the server's epoch
+         * time when it replied. Samples with the reply before the send are ignored.
+         */
+        void AddSample(std::int64_t sent_ms, std::int64_t server_ms, std::int64_t received_ms);
+
+        /**
+         * Takes a sample from a reply if it answers a stamped POLL. True if it did.
+         */
+        bool AddReply(const ReplyTiming &timing);
+
+        [[nodiscard]] bool Synced() const { return !samples_.empty(); }
+
+        /**
+         * Server epoch time minus local_millis(); 0 until synced.
+         */
+        [[nodiscard]] double Offset() const;
+
+        /**
+         * How far Offset() can be off, in milliseconds, as of local time now_ms.
+         */
+        [[nodiscard]] double ErrorBound(std::int64_t now_ms) const;
+
+        /**
+         * local_ms on the server's clock, in epoch milliseconds. Falls back to the local wall
+         * clock until synced.
+         */
+        [[nodiscard]] double ToServer(std::int64_t local_ms) const;
+
+        [[nodiscard]] double ServerNow() const { return ToServer(local_millis()); }
+
+        /**
+         * Lowest round trip in the window.
+         */
+        [[nodiscard]] double MinRoundTrip() const;
+
+        [[nodiscard]] double SmoothedRoundTrip() const { return smoothed_rtt_; }
+
+        [[nodiscard]] double RoundTripVariation() const { return rtt_variation_; }
+
+        /**
+         * Samples taken since the last Reset().
+         */
+        [[nodiscard]] size_t Samples() const { return total_; }
+
+    private:
+        struct Sample {
+            std::int64_t received_ms;
+            double offset;
+            double round_trip;
+        };
+
+        [[nodiscard]] const Sample *Best(std::int64_t now_ms) const;
+
+        size_t window_;
+
+        std::vector<Sample> samples_; // Ring of the latest window_
+        size_t next_{0};
+
+        size_t total_{0};
+
+        double smoothed_rtt_{0};
+
+        double rtt_variation_{0};
+    };
+}
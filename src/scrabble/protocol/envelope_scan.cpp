@@ -0,0 +1,148 @@
+#include "envelope_scan.h"
+
+#include <charconv>
+
+using namespace scrabble;
+
+namespace {
+    class Scanner {
+    public:
+        explicit Scanner(const std::string_view text) : text_(text) {
+        }
+
+        void SkipWhitespace() {
+            while (pos_ < text_.size() &&
+                   (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+                pos_++;
+            }
+        }
+
+        bool Consume(const char c) {
+            SkipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != c) return false;
+            pos_++;
+            return true;
+        }
+
+        [[nodiscard]] char Peek() {
+            SkipWhitespace();
+            return pos_ < text_.size() ? text_[pos_] : '\0';
+        }
+
+        /**
+         * Raw string contents, escapes left as they are (keys we look for have none).
+         */
+        bool String(std::string_view &out) {
+            if (!Consume('"')) return false;
+            const size_t start = pos_;
+            while (pos_ < text_.size() && text_[pos_] != '"') {
+                if (text_[pos_] == '\\') pos_++;
+                pos_++;
+            }
+            if (pos_ >= text_.size()) return false;
+            out = text_.substr(start, pos_ - start);
+            pos_++;
+            return true;
+        }
+
+        /**
+         * Skips one value of any type, leaving its text in out.
+         */
+        bool Value(std::string_view &out) {
+            SkipWhitespace();
+            if (pos_ >= text_.size()) return false;
+            const size_t start = pos_;
+            const char c = text_[pos_];
+            if (c == '"') {
+                std::string_view ignored;
+                if (!String(ignored)) return false;
+            } else if (c == '{' || c == '[') {
+                int depth = 0;
+                while (pos_ < text_.size()) {
+                    const char d = text_[pos_];
+                    if (d == '"') {
+                        std::string_view ignored;
+                        if (!String(ignored)) return false;
+                        continue;
+                    }
+                    pos_++;
+                    if (d == '{' || d == '[') depth++;
+                    else if (d == '}' || d == ']') {
+                        if (--depth == 0) break;
+                    }
+                }
+                if (depth != 0) return false;
+            } else {
+                while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' && text_[pos_] != ']' &&
+                       text_[pos_] != ' ' && text_[pos_] != '\n' && text_[pos_] != '\r' && text_[pos_] != '\t') {
+                    pos_++;
+                }
+                if (pos_ == start) return false;
+            }
+            out = text_.substr(start, pos_ - start);
+            return true;
+        }
+
+        /**
+         * Calls on_key(key) for each member of an object; on_key must consume the value.
+         */
+        template<typename F>
+        bool Object(F &&on_key) {
+            if (!Consume('{')) return false;
+            if (Peek() == '}') return Consume('}');
+            while (true) {
+                std::string_view key;
+                if (!String(key) || !Consume(':')) return false;
+                if (!on_key(key)) return false;
+                if (Consume(',')) continue;
+                return Consume('}');
+            }
+        }
+
+    private:
+        std::string_view text_;
+
+        size_t pos_{0};
+    };
+
+    bool parse_bool(const std::string_view value, bool &out) {
+        if (value == "true") out = true;
+        else if (value == "false") out = false;
+        else return false;
+        return true;
+    }
+
+    template<typename T>
+    bool parse_int(const std::string_view value, std::optional<T> &out) {
+        T parsed = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if (error != std::errc{} || end != value.data() + value.size()) return false;
+        out = parsed;
+        return true;
+    }
+}
+
+bool scrabble::scan_envelope(const std::string_view json, EnvelopeScan &out) {
+    out = EnvelopeScan{};
+    Scanner scanner(json);
+    return scanner.Object([&](const std::string_view key) {
+        std::string_view value;
+        if (key == "game" && scanner.Peek() == '{') {
+            out.has_game = true;
+            return scanner.Object([&](const std::string_view game_key) {
+                std::string_view game_value;
+                if (!scanner.Value(game_value)) return false;
+                if (game_key == "lastAction") out.last_action = game_value;
+                return true;
+            });
+        }
+        if (!scanner.Value(value)) return false;
+        if (key == "ok") return parse_bool(value, out.ok);
+        if (key == "push") return parse_bool(value, out.pushed);
+        if (key == "hashCode") return parse_int(value, out.hash_code);
+        if (key == "serverTime") return parse_int(value, out.server_time);
+        if (key == "pollSent") return parse_int(value, out.poll_sent);
+        if (key == "delta") out.has_delta = true;
+        return true;
+    });
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace scrabble {
+    /**
+     * The few top-level facts about a game socket message needed to decide whether it is worth
+     * decoding. Views point into the scanned text.
+     */
+    struct EnvelopeScan {
+        bool ok{false};
+        bool pushed{false};
+        bool has_delta{false};
+        bool has_game{false};
+        std::optional<int> hash_code;
+        std::optional<std::int64_t> server_time;
+        std::optional<std::int64_t> poll_sent;
+        std::string_view last_action; // Raw JSON of game.lastAction, empty if absent
+    };
+
+    /**
+     * Walks the message without building a DOM or allocating: reads ok, hashCode, push,
+     * serverTime and pollSent, notes whether there is a delta, and finds game.lastAction's text. Everything else is
+     * skipped over. Returns false on anything that isn't a well-formed object, in which case the
+     * caller should fall back to a full decode (which will report the error properly).
+     */
+    bool scan_envelope(std::string_view json, EnvelopeScan &out);
+}
@@ -0,0 +1,227 @@
+#include "game_delta.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <utility>
+
+using namespace scrabble;
+
+namespace {
+    constexpr std::string_view DELTA_POLL_PREFIX = "hash=";
+
+    struct Fnv1a {
+        std::uint32_t value = 2166136261u;
+
+        void Byte(const unsigned char b) {
+            value ^= b;
+            value *= 16777619u;
+        }
+
+        void Bytes(const std::string_view s) {
+            for (const char c: s) Byte(static_cast<unsigned char>(c));
+            Byte(0); // Separator, so "AB","C" and "A","BC" differ
+        }
+
+        void Int(const int v) {
+            for (int shift = 0; shift < 32; shift += 8) Byte(static_cast<unsigned char>(v >> shift));
+        }
+    };
+
+    bool same_tile(const TileProps &a, const TileProps &b) {
+        return a.id == b.id && a.letter == b.letter && a.faceUp == b.faceUp;
+    }
+
+    bool same_words(const std::vector<Word> &a, const std::vector<Word> &b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Word &x, const Word &y) {
+            return x.id == y.id && x.history == y.history;
+        });
+    }
+}
+
+std::uint32_t scrabble::game_digest(const MultiplayerGame &game) {
+    Fnv1a hash;
+    hash.Bytes(game.phase);
+    hash.Int(static_cast<int>(game.state.tiles.size()));
+    for (const auto &tile: game.state.tiles) {
+        hash.Bytes(tile.id);
+        hash.Bytes(tile.letter);
+        hash.Byte(tile.faceUp ? 1 : 0);
+    }
+    hash.Int(static_cast<int>(game.state.playerWords.size()));
+    for (const auto &words: game.state.playerWords) {
+        hash.Int(static_cast<int>(words.size()));
+        for (const auto &word: words) {
+            hash.Bytes(word.id);
+            for (const auto &form: word.history) hash.Bytes(form);
+        }
+    }
+    hash.Int(static_cast<int>(game.chat.size()));
+    for (const auto &message: game.chat) {
+        hash.Byte(message.sender.has_value() ? 1 : 0);
+        hash.Bytes(message.sender.value_or(""));
+        hash.Bytes(message.timestamp);
+        hash.Bytes(message.message);
+    }
+    hash.Int(game.buzzHolder.value_or(-1));
+    hash.Int(game.buzzElapsed.value_or(-1));
+    hash.Byte(game.lastAction.has_value() ? 1 : 0);
+    if (game.lastAction.has_value()) {
+        const auto &action = *game.lastAction;
+        hash.Bytes(action.actionType);
+        hash.Bytes(action.flippedTileId);
+        hash.Bytes(action.claimWord);
+        hash.Bytes(action.stolenWordId);
+        hash.Int(action.actingPlayer);
+        hash.Int(action.stolenPlayer.value_or(-1));
+    }
+    // Not in a delta, but a delta only fits the game it was made from
+    hash.Int(static_cast<int>(game.playerIds.size()));
+    for (const int id: game.playerIds) hash.Int(id);
+    hash.Bytes(game.state.dictionary);
+    return hash.value;
+}
+
+std::string scrabble::delta_poll_data(const int hash_code) {
+    std::string out;
+    write_delta_poll_data(out, hash_code);
+    return out;
+}
+
+void scrabble::write_delta_poll_data(std::string &out, const int hash_code) {
+    char digits[16];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), hash_code);
+    out.assign(DELTA_POLL_PREFIX);
+    out.append(digits, end);
+}
+
+std::optional<int> scrabble::parse_delta_poll_data(const std::string &data) {
+    if (!data.starts_with(DELTA_POLL_PREFIX)) return std::nullopt;
+    int hash_code = 0;
+    const char *first = data.data() + DELTA_POLL_PREFIX.size();
+    // Other fields (see append_poll_sent) may follow, after an '&'
+    const char *last = data.data() + std::min(data.find('&'), data.size());
+    const auto [end, error] = std::from_chars(first, last, hash_code);
+    if (error != std::errc{} || end != last) return std::nullopt;
+    return hash_code;
+}
+
+std::optional<GameDelta> scrabble::make_game_delta(const MultiplayerGame &from, const MultiplayerGame &to,
+                                                   const int base_hash) {
+    if (from.id != to.id || from.playerIds != to.playerIds || from.playerNames != to.playerNames) return std::nullopt;
+    if (from.state.dictionary != to.state.dictionary || from.state.playerCount != to.state.playerCount ||
+        from.state.wordMinimumSize != to.state.wordMinimumSize || from.state.tileCount != to.state.tileCount ||
+        from.state.playerWords.size() != to.state.playerWords.size()) {
+        return std::nullopt;
+    }
+    if (to.chat.size() < from.chat.size()) return std::nullopt;
+
+    GameDelta delta{};
+    delta.baseHash = base_hash;
+    delta.phase = to.phase;
+
+    // Tiles only ever disappear or flip mid-game, and keep their relative order. Anything else
+    // (a reshuffle) would need more than removals and in-place changes to describe.
+    size_t j = 0;
+    for (const auto &tile: from.state.tiles) {
+        if (j < to.state.tiles.size() && to.state.tiles[j].id == tile.id) {
+            if (!same_tile(tile, to.state.tiles[j])) delta.changedTiles.push_back(to.state.tiles[j]);
+            j++;
+        } else {
+            delta.removedTileIds.push_back(tile.id);
+        }
+    }
+    for (; j < to.state.tiles.size(); j++) {
+        delta.changedTiles.push_back(to.state.tiles[j]);
+    }
+
+    for (int player = 0; player < static_cast<int>(to.state.playerWords.size()); player++) {
+        if (!same_words(from.state.playerWords[player], to.state.playerWords[player])) {
+            delta.changedPlayers.push_back({player, to.state.playerWords[player]});
+        }
+    }
+
+    delta.chatStart = static_cast<int>(from.chat.size());
+    delta.newChat.assign(to.chat.begin() + static_cast<std::ptrdiff_t>(from.chat.size()), to.chat.end());
+    delta.buzzHolder = to.buzzHolder;
+    delta.buzzElapsed = to.buzzElapsed;
+    delta.lastAction = to.lastAction;
+    delta.digest = game_digest(to);
+
+    // Check the delta actually reproduces to (e.g. a tile that moved within the list)
+    auto check = from;
+    if (!apply_game_delta(check, delta)) return std::nullopt;
+    return delta;
+}
+
+bool scrabble::apply_game_delta(MultiplayerGame &game, const GameDelta &delta) {
+    for (const auto &changed: delta.changedPlayers) {
+        if (changed.player < 0 || changed.player >= static_cast<int>(game.state.playerWords.size())) return false;
+    }
+    if (delta.chatStart < 0 || delta.chatStart > static_cast<int>(game.chat.size())) return false;
+
+    // Whatever gets overwritten is moved aside, so a digest mismatch can put it all back
+    auto &tiles = game.state.tiles;
+    std::vector<std::pair<size_t, TileProps> > removed_tiles;
+    if (!delta.removedTileIds.empty()) {
+        size_t kept = 0;
+        for (size_t i = 0; i < tiles.size(); i++) {
+            if (std::find(delta.removedTileIds.begin(), delta.removedTileIds.end(), tiles[i].id) !=
+                delta.removedTileIds.end()) {
+                removed_tiles.emplace_back(i, std::move(tiles[i]));
+            } else {
+                if (kept != i) tiles[kept] = std::move(tiles[i]);
+                kept++;
+            }
+        }
+        tiles.erase(tiles.begin() + static_cast<std::ptrdiff_t>(kept), tiles.end());
+    }
+    const size_t kept_tiles = tiles.size();
+    std::vector<std::pair<size_t, TileProps> > replaced_tiles;
+    for (const auto &changed: delta.changedTiles) {
+        const auto it = std::find_if(tiles.begin(), tiles.end(), [&changed](const TileProps &tile) {
+            return tile.id == changed.id;
+        });
+        if (it != tiles.end()) {
+            replaced_tiles.emplace_back(it - tiles.begin(), std::exchange(*it, changed));
+        } else {
+            tiles.push_back(changed);
+        }
+    }
+
+    std::vector<std::vector<Word> > replaced_words;
+    replaced_words.reserve(delta.changedPlayers.size());
+    for (const auto &[player, words]: delta.changedPlayers) {
+        replaced_words.push_back(std::exchange(game.state.playerWords[player], words));
+    }
+
+    const auto chat_start = game.chat.begin() + delta.chatStart;
+    std::vector<MultiplayerChatMessage> replaced_chat(std::make_move_iterator(chat_start),
+                                                      std::make_move_iterator(game.chat.end()));
+    game.chat.erase(chat_start, game.chat.end());
+    game.chat.insert(game.chat.end(), delta.newChat.begin(), delta.newChat.end());
+
+    auto phase = std::exchange(game.phase, delta.phase);
+    const auto buzz_holder = std::exchange(game.buzzHolder, delta.buzzHolder);
+    const auto buzz_elapsed = std::exchange(game.buzzElapsed, delta.buzzElapsed);
+    auto last_action = std::exchange(game.lastAction, delta.lastAction);
+    if (game_digest(game) == delta.digest) return true;
+
+    game.phase = std::move(phase);
+    game.buzzHolder = buzz_holder;
+    game.buzzElapsed = buzz_elapsed;
+    game.lastAction = std::move(last_action);
+    game.chat.resize(static_cast<size_t>(delta.chatStart));
+    std::move(replaced_chat.begin(), replaced_chat.end(), std::back_inserter(game.chat));
+    for (size_t i = replaced_words.size(); i-- > 0;) {
+        game.state.playerWords[delta.changedPlayers[i].player] = std::move(replaced_words[i]);
+    }
+    for (auto it = replaced_tiles.rbegin(); it != replaced_tiles.rend(); ++it) {
+        tiles[it->first] = std::move(it->second);
+    }
+    tiles.erase(tiles.begin() + static_cast<std::ptrdiff_t>(kept_tiles), tiles.end());
+    for (auto &[index, tile]: removed_tiles) {
+        tiles.insert(tiles.begin() + static_cast<std::ptrdiff_t>(index), std::move(tile));
+    }
+    return false;
+}
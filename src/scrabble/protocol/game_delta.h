@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "scrabble/context/types.h"
+
+namespace scrabble {
+    struct PlayerWordsDelta {
+        int player;
+        std::vector<Word> words; // The player's whole new word list
+    };
+
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(PlayerWordsDelta, player, words)
+
+    /**
+     * What changed in a MultiplayerGame since the snapshot whose hashCode was baseHash. Only
+     * meaningful mid-game: anything structural (players, dictionary, a shrinking chat) means a
+     * full snapshot instead.
+     */
+    struct GameDelta {
+        int baseHash;
+        std::string phase;
+        std::vector<std::string> removedTileIds;
+        std::vector<TileProps> changedTiles; // Replaced in place by id, appended if new
+        std::vector<PlayerWordsDelta> changedPlayers;
+        int chatStart; // Index newChat starts at; everything before it is unchanged
+        std::vector<MultiplayerChatMessage> newChat;
+        std::optional<int> buzzHolder;
+        std::optional<int> buzzElapsed;
+        std::optional<GameStateUpdate> lastAction;
+        std::uint32_t digest; // game_digest of the result, checked after applying
+    };
+
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(
+        GameDelta,
+        baseHash,
+        phase,
+        removedTileIds,
+        changedTiles,
+        changedPlayers,
+        chatStart,
+        newChat,
+        buzzHolder,
+        buzzElapsed,
+        lastAction,
+        digest
+    )
+
+    /**
+     * Sent instead of a MultiplayerActionResponse when the POLL carried a hash the server still
+     * knows. Told apart from a full response by its "delta" key.
+     */
+    struct GameDeltaResponse {
+        bool ok;
+        GameDelta delta;
+        int hashCode;
+        std::string errorMessage;
+        bool pushed{false}; // Not serialized, see MultiplayerActionResponse
+        ReplyTiming timing{};
+    };
+
+    STREAM_DEFINE_TYPE_NON_INTRUSIVE(GameDeltaResponse, ok, delta, hashCode, errorMessage)
+
+    /**
+     * FNV-1a over everything a delta can change, plus the players and dictionary it must leave
+     * alone. Both sides compute it the same way; it is not the server's hashCode.
+     */
+    std::uint32_t game_digest(const MultiplayerGame &game);
+
+    /**
+     * POLL data acknowledging the last applied hashCode, asking for a delta.
+     */
+    std::string delta_poll_data(int hash_code);
+
+    /**
+     * delta_poll_data written into out (replacing its contents), for callers reusing a buffer.
+     */
+    void write_delta_poll_data(std::string &out, int hash_code);
+
+    /**
+     * Reads delta_poll_data back; nullopt for an ordinary POLL.
+     */
+    std::optional<int> parse_delta_poll_data(const std::string &data);
+
+    /**
+     * The delta taking from to to, or nullopt if only a full snapshot will do.
+     */
+    std::optional<GameDelta> make_game_delta(const MultiplayerGame &from, const MultiplayerGame &to, int base_hash);
+
+    /**
+     * Applies delta to game in place. Returns false if it doesn't fit or the digest doesn't match,
+     * in which case game is left as it was and the caller should ask for a full snapshot.
+     */
+    bool apply_game_delta(MultiplayerGame &game, const GameDelta &delta);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <variant>
+
+#include "concurrentqueue.h"
+
+#include "game_delta.h"
+#include "scrabble/context/types.h"
+
+namespace scrabble {
+    /**
+     * A game socket message that could not be turned into a MultiplayerActionResponse.
+     */
+    struct ProtocolError {
+        std::string what;
+        std::string excerpt; // Start of the offending message, for the log
+    };
+
+    /**
+     * A response the decoder dropped without decoding: same hashCode as the last snapshot it passed
+     * on, or superseded by a newer one in the same batch. Still delivered so poll round trips can
+     * be paired up.
+     */
+    struct SkippedResponse {
+        bool pushed;
+        ReplyTiming timing{};
+    };
+
+    /**
+     * What the game socket delivers to the main thread: a full snapshot, a delta against the last
+     * one, a response not worth decoding, or the reason the message couldn't be decoded.
+     */
+    using GameMessage = std::variant<MultiplayerActionResponse, GameDeltaResponse, SkippedResponse, ProtocolError>;
+
+    using GameMessageQueue = moodycamel::ConcurrentQueue<GameMessage>;
+
+    /**
+     * message's timing; null for a ProtocolError.
+     */
+    inline const ReplyTiming *reply_timing(const GameMessage &message) {
+        if (const auto *response = std::get_if<MultiplayerActionResponse>(&message)) return &response->timing;
+        if (const auto *delta = std::get_if<GameDeltaResponse>(&message)) return &delta->timing;
+        if (const auto *skipped = std::get_if<SkippedResponse>(&message)) return &skipped->timing;
+        return nullptr;
+    }
+}
@@ -0,0 +1,194 @@
+#include "game_message_decoder.h"
+
+#include <chrono>
+
+#include "clock_sync.h"
+#include "envelope_scan.h"
+#include "util/serialization/serialization.h"
+#include "util/serialization/stream_decode.h"
+
+using namespace scrabble;
+
+namespace {
+    constexpr size_t EXCERPT_LENGTH = 120;
+
+    std::optional<std::int64_t> optional_int(const nlohmann::json &json, const char *key) {
+        const auto it = json.find(key);
+        if (it == json.end() || !it->is_number_integer()) return std::nullopt;
+        return it->get<std::int64_t>();
+    }
+
+    /**
+     * The DOM path, shared by text and binary frames. Throws json::exception.
+     */
+    GameMessage decode_json(const nlohmann::json &json, const std::string &excerpt) {
+        const bool pushed = json.value("push", false);
+        const ReplyTiming timing{optional_int(json, "serverTime"), optional_int(json, "pollSent")};
+        if (json.contains("delta")) {
+            auto delta = json.get<GameDeltaResponse>();
+            delta.pushed = pushed;
+            delta.timing = timing;
+            return delta;
+        }
+        auto response = json.get<MultiplayerActionResponse>();
+        response.pushed = pushed;
+        response.timing = timing;
+        if (response.ok && !response.game.has_value()) {
+            return ProtocolError{"ok response without a game", excerpt};
+        }
+        return response;
+    }
+
+    void stamp_received(GameMessage &message, const std::int64_t received) {
+        if (auto *response = std::get_if<MultiplayerActionResponse>(&message)) {
+            response->timing.receivedAt = received;
+        } else if (auto *delta = std::get_if<GameDeltaResponse>(&message)) {
+            delta->timing.receivedAt = received;
+        }
+    }
+}
+
+GameMessage scrabble::decode_game_message(const std::string &raw) {
+    // Streaming decode first; anything it rejects goes through the DOM, which also words the error
+    if (EnvelopeScan scan; scan_envelope(raw, scan)) {
+        if (scan.has_delta) {
+            GameDeltaResponse delta;
+            if (stream_deserialize(raw, delta)) {
+                delta.pushed = scan.pushed;
+                delta.timing = ReplyTiming{scan.server_time, scan.poll_sent};
+                return delta;
+            }
+        } else if (MultiplayerActionResponse response; stream_deserialize(raw, response)) {
+            response.pushed = scan.pushed;
+            response.timing = ReplyTiming{scan.server_time, scan.poll_sent};
+            if (response.ok && !response.game.has_value()) {
+                return ProtocolError{"ok response without a game", raw.substr(0, EXCERPT_LENGTH)};
+            }
+            return response;
+        }
+    }
+    try {
+        return decode_json(nlohmann::json::parse(raw), raw.substr(0, EXCERPT_LENGTH));
+    } catch (const nlohmann::json::exception &e) {
+        return ProtocolError{e.what(), raw.substr(0, EXCERPT_LENGTH)};
+    }
+}
+
+GameMessage scrabble::decode_binary_game_message(const std::string &raw) {
+    const auto excerpt = std::to_string(raw.size()) + " bytes of MessagePack";
+    try {
+        return decode_json(nlohmann::json::from_msgpack(raw), excerpt);
+    } catch (const nlohmann::json::exception &e) {
+        return ProtocolError{e.what(), excerpt};
+    }
+}
+
+GameMessageDecoder::GameMessageDecoder(GameMessageQueue &out) : out_(out), thread_(&GameMessageDecoder::Run, this) {
+}
+
+GameMessageDecoder::~GameMessageDecoder() {
+    stopping_.store(true, std::memory_order_release);
+    raw_.enqueue(Frame{}); // Wake the worker
+    thread_.join();
+}
+
+void GameMessageDecoder::Push(const std::string_view raw, const WireFormat format) {
+    if (format == WireFormat::MessagePack) binary_seen_.store(true, std::memory_order_relaxed);
+    raw_.enqueue(Frame{buffers_.Copy(raw), format, local_millis()});
+}
+
+void GameMessageDecoder::Forward(GameMessage message, const long micros) {
+    last_decode_us_.store(micros, std::memory_order_relaxed);
+    if (std::holds_alternative<ProtocolError>(message)) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        decoded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    out_.enqueue(std::move(message));
+}
+
+void GameMessageDecoder::FlushPending() {
+    if (!has_pending_) return;
+    has_pending_ = false;
+    const auto start = std::chrono::steady_clock::now();
+    auto message = decode_game_message(pending_.Data());
+    pending_.Release();
+    stamp_received(message, pending_timing_.receivedAt);
+    if (auto *response = std::get_if<MultiplayerActionResponse>(&message)) {
+        if (pending_action_is_new_) pending_actions_.pop_back(); // It is the response's own lastAction
+        response->skippedActions = std::move(pending_actions_);
+        last_hash_ = response->hashCode;
+    }
+    pending_actions_.clear();
+    pending_action_is_new_ = false;
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    Forward(std::move(message), std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+void GameMessageDecoder::Run() {
+    constexpr size_t BATCH = 16;
+    std::vector<Frame> batch(BATCH);
+    EnvelopeScan scan;
+    while (true) {
+        const size_t count = raw_.wait_dequeue_bulk(batch.begin(), BATCH);
+        if (stopping_.load(std::memory_order_acquire)) return;
+        if (reset_requested_.exchange(false, std::memory_order_acq_rel)) {
+            last_hash_.reset();
+            last_action_text_.clear();
+        }
+        for (size_t i = 0; i < count; i++) {
+            // Taken out of the batch so the buffer goes back to the pool at the end of the iteration
+            Frame frame = std::move(batch[i]);
+            const auto &raw = frame.data.Data();
+            const bool binary = frame.format == WireFormat::MessagePack;
+            if (binary || !scan_envelope(raw, scan) ||
+                !scan.ok || scan.has_delta || !scan.has_game || !scan.hash_code) {
+                // Not a plain snapshot: keep ordering with anything held back, then decode it as is
+                FlushPending();
+                const auto start = std::chrono::steady_clock::now();
+                auto message = binary ? decode_binary_game_message(raw) : decode_game_message(raw);
+                stamp_received(message, frame.received);
+                if (std::holds_alternative<GameDeltaResponse>(message)) {
+                    // A delta the main thread can't apply is followed by a snapshot with the same
+                    // hashCode, which must not be mistaken for a repeat
+                    last_hash_.reset();
+                } else if (const auto *response = std::get_if<MultiplayerActionResponse>(&message);
+                    response != nullptr && response->ok) {
+                    last_hash_ = response->hashCode;
+                }
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                Forward(std::move(message), std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+                continue;
+            }
+
+            const bool has_action = !scan.last_action.empty() && scan.last_action != "null";
+            // Whether pending_actions_.back() is this snapshot's own lastAction
+            bool own_action = has_action && !pending_actions_.empty();
+            if (has_action && scan.last_action != last_action_text_) {
+                last_action_text_.assign(scan.last_action);
+                own_action = stream_deserialize(scan.last_action, pending_actions_.emplace_back());
+                if (!own_action) {
+                    pending_actions_.pop_back(); // The full decode of this snapshot (if it is the newest) will report it
+                }
+            }
+
+            const ReplyTiming timing{scan.server_time, scan.poll_sent, frame.received};
+            if (scan.hash_code == last_hash_) {
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+                out_.enqueue(SkippedResponse{scan.pushed, timing});
+                continue;
+            }
+            if (has_pending_) {
+                // Superseded by this one before anyone needed it
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+                out_.enqueue(SkippedResponse{pending_pushed_, pending_timing_});
+            }
+            pending_ = std::move(frame.data);
+            has_pending_ = true;
+            pending_pushed_ = scan.pushed;
+            pending_timing_ = timing;
+            pending_action_is_new_ = own_action;
+        }
+        FlushPending();
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blockingconcurrentqueue.h"
+
+#include "game_message.h"
+#include "wire_format.h"
+#include "util/memory/buffer_pool.h"
+
+namespace scrabble {
+    /**
+     * Decodes raw game socket frames on its own thread, so a large snapshot costs the main
+     * thread a dequeue instead of a full JSON parse.
+     *
+     * Each frame is prescanned first (scan_envelope). A snapshot with the same hashCode as the
+     * last one passed on is dropped undecoded, and of several snapshots waiting at once only the
+     * newest is decoded; the lastActions of the others are decoded on their own and passed along
+     * in skippedActions. Deltas and errors are always decoded, in order.
+     *
+     * Binary (MessagePack) frames skip the prescan and are always decoded in full.
+     */
+    class GameMessageDecoder {
+    public:
+        explicit GameMessageDecoder(GameMessageQueue &out);
+
+        GameMessageDecoder(const GameMessageDecoder &) = delete;
+
+        GameMessageDecoder &operator=(const GameMessageDecoder &) = delete;
+
+        /**
+         * Drops anything still undecoded.
+         */
+        ~GameMessageDecoder();
+
+        /**
+         * Safe from any thread; meant to be called from the socket's message callbacks. raw is
+         * copied into a pooled buffer, which goes back to the pool once decoded, and stamped with
+         * the time for its ReplyTiming.
+         */
+        void Push(std::string_view raw, WireFormat format);
+
+        /**
+         * Forget the last hashCode and action, e.g. when switching games. Takes effect before the
+         * next frame is looked at.
+         */
+        void Reset() {
+            binary_seen_.store(false, std::memory_order_relaxed);
+            reset_requested_.store(true, std::memory_order_release);
+        }
+
+        /**
+         * True once the server has sent a binary frame since the last Reset, i.e. it accepted the
+         * MessagePack request and will read MessagePack back.
+         */
+        [[nodiscard]] bool BinarySeen() const { return binary_seen_.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] size_t DecodedCount() const { return decoded_.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] size_t ErrorCount() const { return errors_.load(std::memory_order_relaxed); }
+
+        /**
+         * Frames dropped by the prescan, unchanged or superseded.
+         */
+        [[nodiscard]] size_t SkippedCount() const { return skipped_.load(std::memory_order_relaxed); }
+
+        /**
+         * Microseconds spent decoding the most recent message.
+         */
+        [[nodiscard]] long LastDecodeMicros() const { return last_decode_us_.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] const BufferPool &Buffers() const { return buffers_; }
+
+    private:
+        struct Frame {
+            PooledBuffer data;
+            WireFormat format{WireFormat::Json};
+            std::int64_t received{0}; // local_millis() when pushed
+        };
+
+        void Run();
+
+        void Forward(GameMessage message, long micros);
+
+        /**
+         * Decodes the snapshot held back in pending_ (if any), with pending_actions_ attached.
+         */
+        void FlushPending();
+
+        BufferPool buffers_; // First, so it outlives every frame below
+
+        // Worker thread only
+        PooledBuffer pending_;
+
+        bool has_pending_{false};
+
+        bool pending_pushed_{false};
+
+        ReplyTiming pending_timing_;
+
+        std::vector<GameStateUpdate> pending_actions_;
+
+        bool pending_action_is_new_{false}; // pending_actions_.back() is the held snapshot's own lastAction
+
+        std::optional<int> last_hash_; // Of the last snapshot passed on
+
+        std::string last_action_text_;
+
+        GameMessageQueue &out_;
+
+        moodycamel::BlockingConcurrentQueue<Frame> raw_;
+
+        std::atomic<bool> stopping_{false};
+
+        std::atomic<size_t> decoded_{0};
+
+        std::atomic<size_t> errors_{0};
+
+        std::atomic<size_t> skipped_{0};
+
+        std::atomic<bool> reset_requested_{false};
+
+        std::atomic<bool> binary_seen_{false};
+
+        std::atomic<long> last_decode_us_{0};
+
+        std::thread thread_;
+    };
+
+    /**
+     * The decode step itself, on whatever thread calls it.
+     */
+    GameMessage decode_game_message(const std::string &raw);
+
+    /**
+     * decode_game_message for a MessagePack frame.
+     */
+    GameMessage decode_binary_game_message(const std::string &raw);
+}
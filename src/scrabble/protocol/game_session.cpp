@@ -0,0 +1,224 @@
+#include "game_session.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "game_message_decoder.h"
+
+using namespace scrabble;
+
+namespace {
+    // Enough for the messages a busy frame queues; more than that are freed
+    constexpr size_t MAX_SPARE_BUFFERS = 32;
+}
+
+GameSession::GameSession(std::string url, std::string token, GameMessageDecoder *decoder, SocketFactory make_socket,
+                         const ReconnectSettings settings)
+    : url_(std::move(url)),
+      token_(std::move(token)),
+      decoder_(decoder),
+      make_socket_(std::move(make_socket)),
+      settings_(settings),
+      rng_(std::random_device{}()) {
+    for (auto &latency: send_latency_) latency = LatencyRecorder::Window(256);
+    spare_buffers_.reserve(MAX_SPARE_BUFFERS);
+    Connect();
+}
+
+GameSession::~GameSession() {
+    if (socket_ != nullptr) socket_->close();
+    socket_.reset(); // Before anything its callbacks touch goes away
+}
+
+void GameSession::Connect() {
+    const auto generation = ++generation_;
+    status_ = Status::Connecting;
+    socket_ = make_socket_(url_);
+    auto *socket = socket_.get();
+    socket->on_open = [this, socket, generation] {
+        // Authenticate before the main thread hears about it, so nothing can be sent ahead of the token
+        socket->send(token_);
+        events_.enqueue({Event::Kind::Opened, generation, ""});
+    };
+    socket->on_message = [this](const std::string &msg) {
+        if (measure_resync_.exchange(false, std::memory_order_relaxed)) {
+            resync_bytes_.store(msg.size(), std::memory_order_relaxed);
+        }
+        decoder_->Push(msg, WireFormat::Json);
+    };
+    socket->on_binary_message = [this](const std::string &msg) {
+        if (measure_resync_.exchange(false, std::memory_order_relaxed)) {
+            resync_bytes_.store(msg.size(), std::memory_order_relaxed);
+        }
+        decoder_->Push(msg, WireFormat::MessagePack);
+    };
+    socket->on_error = [this, generation](const std::string &err) {
+        events_.enqueue({Event::Kind::Closed, generation, err});
+    };
+    socket->on_close = [this, generation] {
+        events_.enqueue({Event::Kind::Closed, generation, "closed"});
+    };
+    socket->connect();
+}
+
+void GameSession::Update(const float delta_time) {
+    now_ += delta_time;
+    Event event;
+    while (events_.try_dequeue(event)) {
+        if (event.generation != generation_) continue; // From a socket already replaced
+        if (event.kind == Event::Kind::Closed) {
+            OnClosed(event.reason);
+            continue;
+        }
+        if (status_ != Status::Connecting) continue;
+        status_ = Status::Open;
+        attempt_ = 0;
+        if (ever_opened_) {
+            reconnects_++;
+            last_reconnect_ = now_ - dropped_at_;
+            reconnect_times_.Record(static_cast<double>(last_reconnect_) * 1000.0);
+            reconnected_ = true;
+            measure_resync_.store(true, std::memory_order_relaxed);
+        }
+        ever_opened_ = true;
+        // In the order they were taken, not by class: a CLAIM may use the tile a FLIP before it turned
+        const auto now = std::chrono::steady_clock::now();
+        for (auto &message: unsent_) {
+            Transmit(message.message, message.format);
+            const auto i = static_cast<size_t>(message.send_class);
+            send_latency_[i].Record(now - message.queued_at);
+            sent_[i]++;
+            Recycle(std::move(message.message));
+        }
+        unsent_.clear();
+        Flush();
+    }
+    if (status_ == Status::WaitingToReconnect && now_ >= retry_at_) {
+        Connect();
+    }
+}
+
+void GameSession::OnClosed(const std::string &reason) {
+    if (status_ == Status::WaitingToReconnect) return;
+    if (status_ == Status::Open) {
+        drops_++;
+        dropped_at_ = now_;
+    } else {
+        attempt_++;
+    }
+    last_error_ = reason;
+    // Queued but not flushed: actions wait for the next connection, back in the order they were
+    // queued; the rest is dropped
+    std::vector<Outgoing> kept;
+    for (auto &queue: outbox_) {
+        for (auto &message: queue) {
+            if (message.keep) kept.push_back(std::move(message));
+            else Recycle(std::move(message.message));
+        }
+        queue.clear();
+    }
+    std::ranges::stable_sort(kept, {}, &Outgoing::queued_at);
+    for (auto &message: kept) {
+        KeepUnsent(std::move(message));
+    }
+    socket_->close();
+    socket_.reset();
+    generation_++; // Whatever the old socket still says is stale
+    const float cap = std::min(settings_.max_delay,
+                               settings_.initial_delay * std::pow(settings_.multiplier, static_cast<float>(attempt_)));
+    std::uniform_real_distribution<float> jitter(0.0f, cap / 2);
+    retry_at_ = now_ + cap / 2 + jitter(rng_);
+    status_ = Status::WaitingToReconnect;
+}
+
+bool GameSession::Send(const std::string &message, const WireFormat format, const SendClass send_class) {
+    if (status_ != Status::Open) return false;
+    auto &queue = outbox_[static_cast<size_t>(send_class)];
+    if (send_class == SendClass::Poll && !queue.empty()) {
+        // The newer POLL acknowledges a newer hash; the older one would only fetch a stale answer
+        queue.back().message.assign(message);
+        queue.back().format = format;
+        queue.back().queued_at = std::chrono::steady_clock::now();
+        coalesced_polls_++;
+        return true;
+    }
+    queue.push_back(MakeOutgoing(message, format, send_class, false));
+    return true;
+}
+
+void GameSession::SendOrQueue(const std::string &message, const WireFormat format, const SendClass send_class) {
+    if (status_ == Status::Open) {
+        outbox_[static_cast<size_t>(send_class)].push_back(MakeOutgoing(message, format, send_class, true));
+        return;
+    }
+    KeepUnsent(MakeOutgoing(message, format, send_class, true));
+}
+
+void GameSession::KeepUnsent(Outgoing message) {
+    if (unsent_.size() == settings_.max_unsent) {
+        Recycle(std::move(unsent_.front().message));
+        unsent_.pop_front();
+        discarded_++;
+    }
+    unsent_.push_back(std::move(message));
+}
+
+GameSession::Outgoing GameSession::MakeOutgoing(const std::string &message, const WireFormat format,
+                                                const SendClass send_class, const bool keep) {
+    std::string buffer;
+    if (!spare_buffers_.empty()) {
+        buffer = std::move(spare_buffers_.back());
+        spare_buffers_.pop_back();
+    }
+    buffer.assign(message);
+    return {std::move(buffer), format, send_class, keep, std::chrono::steady_clock::now()};
+}
+
+void GameSession::Recycle(std::string buffer) {
+    if (spare_buffers_.size() < MAX_SPARE_BUFFERS) spare_buffers_.push_back(std::move(buffer));
+}
+
+void GameSession::Flush() {
+    if (status_ != Status::Open) return;
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < SEND_CLASSES; i++) {
+        for (auto &message: outbox_[i]) {
+            Transmit(message.message, message.format);
+            send_latency_[i].Record(now - message.queued_at);
+            sent_[i]++;
+            Recycle(std::move(message.message));
+        }
+        outbox_[i].clear();
+    }
+}
+
+bool GameSession::TakeReconnected() {
+    return std::exchange(reconnected_, false);
+}
+
+void GameSession::Transmit(const std::string &message, const WireFormat format) const {
+    if (format == WireFormat::MessagePack) socket_->send_binary(message);
+    else socket_->send(message);
+}
+
+const char *scrabble::to_string(const GameSession::Status status) {
+    switch (status) {
+        case GameSession::Status::Connecting: return "connecting";
+        case GameSession::Status::Open: return "open";
+        case GameSession::Status::WaitingToReconnect: return "waiting to reconnect";
+    }
+    return "";
+}
+
+const char *scrabble::to_string(const GameSession::SendClass send_class) {
+    switch (send_class) {
+        case GameSession::SendClass::Claim: return "claim";
+        case GameSession::SendClass::Flip: return "flip";
+        case GameSession::SendClass::Control: return "control";
+        case GameSession::SendClass::Poll: return "poll";
+        case GameSession::SendClass::Chat: return "chat";
+    }
+    return "";
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "concurrentqueue.h"
+
+#include "wire_format.h"
+#include "util/network/sockets/web_socket.h"
+#include "util/stats/latency_recorder.h"
+
+namespace scrabble {
+    class GameMessageDecoder;
+
+    /**
+     * Seconds, except max_unsent.
+     */
+    struct ReconnectSettings {
+        float initial_delay = 0.25f;
+        float max_delay = 8.0f;
+        float multiplier = 2.0f;
+        size_t max_unsent = 16; // Actions kept while disconnected; the oldest go first
+    };
+
+    /**
+     * The game socket plus what it takes to survive a dropped connection. When the socket closes
+     * or fails, a new one is opened after a jittered exponential backoff (half the delay fixed,
+     * half random, so clients dropped together don't come back together). Actions the player
+     * takes meanwhile wait in a bounded queue and go out, in order, once the new socket opens.
+     *
+     * The session only restores the transport; after TakeReconnected() the owner resubscribes and
+     * POLLs with the last applied hashCode, which gets a delta from servers that have one and a
+     * single snapshot from those that don't.
+     *
+     * Outgoing messages are queued by SendClass and go out together on Flush(), most urgent class
+     * first, so a CLAIM queued in the same frame as a chat message or a POLL goes out ahead of
+     * them, and a BUZZ and its CLAIM leave back to back. Of several POLLs queued before a flush,
+     * only the newest is sent. Actions kept across a reconnect skip the classes and go out first,
+     * in the order they were taken.
+     *
+     * Frames go straight from the socket thread to the decoder. Everything else, including
+     * reconnecting, happens in Update() on the main thread.
+     */
+    class GameSession {
+    public:
+        enum class Status {
+            Connecting, Open, WaitingToReconnect
+        };
+
+        /**
+         * Most urgent first.
+         */
+        enum class SendClass {
+            Claim, // BUZZ and CLAIM
+            Flip,
+            Control, // START, END, SUBSCRIBE
+            Poll,
+            Chat,
+        };
+
+        static constexpr size_t SEND_CLASSES = 5;
+
+        using SocketFactory = std::function<WebSocketImpl::Ptr(const std::string &url)>;
+
+        /**
+         * Connects right away. decoder gets every frame received and must outlive the session.
+         * token is sent first on every connection.
+         */
+        GameSession(std::string url, std::string token, GameMessageDecoder *decoder, SocketFactory make_socket,
+                    ReconnectSettings settings = {});
+
+        GameSession(const GameSession &) = delete;
+
+        GameSession &operator=(const GameSession &) = delete;
+
+        ~GameSession();
+
+        /**
+         * Handles socket events and reconnects when the backoff is over.
+         */
+        void Update(float delta_time);
+
+        /**
+         * Queues the message for the next Flush() if connected, otherwise drops it and returns
+         * false. For messages that are worthless late, like POLL. A POLL replaces one still queued.
+         */
+        bool Send(const std::string &message, WireFormat format, SendClass send_class);
+
+        /**
+         * Queues the message for the next Flush(), or for the next connection if there is none.
+         * For FLIP, BUZZ and CLAIM.
+         */
+        void SendOrQueue(const std::string &message, WireFormat format, SendClass send_class);
+
+        /**
+         * Sends everything queued, most urgent class first. Call once everything a frame sends
+         * has been queued.
+         */
+        void Flush();
+
+        /**
+         * True once after each reconnect, when the owner should resubscribe and resync.
+         */
+        bool TakeReconnected();
+
+        [[nodiscard]] Status CurrentStatus() const { return status_; }
+
+        /**
+         * Seconds until the next attempt, while WaitingToReconnect.
+         */
+        [[nodiscard]] float RetryIn() const { return retry_at_ - now_; }
+
+        /**
+         * Why the last socket closed.
+         */
+        [[nodiscard]] const std::string &LastError() const { return last_error_; }
+
+        /**
+         * Failed connects since the last successful one.
+         */
+        [[nodiscard]] int Attempt() const { return attempt_; }
+
+        [[nodiscard]] size_t Drops() const { return drops_; }
+
+        [[nodiscard]] size_t Reconnects() const { return reconnects_; }
+
+        /**
+         * Queued actions discarded because the queue was full.
+         */
+        [[nodiscard]] size_t DiscardedActions() const { return discarded_; }
+
+        [[nodiscard]] size_t Unsent() const { return unsent_.size(); }
+
+        /**
+         * Queueing to being written to the socket, for one class; includes waiting for a
+         * connection.
+         */
+        LatencyRecorder &SendLatency(const SendClass send_class) {
+            return send_latency_[static_cast<size_t>(send_class)];
+        }
+
+        [[nodiscard]] size_t Sent(const SendClass send_class) const {
+            return sent_[static_cast<size_t>(send_class)];
+        }
+
+        /**
+         * POLLs replaced by a newer one before they went out.
+         */
+        [[nodiscard]] size_t CoalescedPolls() const { return coalesced_polls_; }
+
+        /**
+         * Time from losing the connection to having a new one open.
+         */
+        LatencyRecorder &ReconnectTimes() { return reconnect_times_; }
+
+        /**
+         * Seconds the latest reconnect took.
+         */
+        [[nodiscard]] float LastReconnectTime() const { return last_reconnect_; }
+
+        /**
+         * Size of the first frame received on the latest reconnected socket: the resync reply.
+         */
+        [[nodiscard]] size_t LastResyncBytes() const { return resync_bytes_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Event {
+            enum class Kind {
+                Opened, Closed
+            };
+
+            Kind kind;
+            std::uint64_t generation;
+            std::string reason;
+        };
+
+        struct Outgoing {
+            std::string message;
+            WireFormat format;
+            SendClass send_class;
+            bool keep; // Queued with SendOrQueue: survives a lost connection
+            std::chrono::steady_clock::time_point queued_at;
+        };
+
+        void Connect();
+
+        void OnClosed(const std::string &reason);
+
+        void Transmit(const std::string &message, WireFormat format) const;
+
+        /**
+         * Keeps message for the next connection, dropping the oldest kept one if full.
+         */
+        void KeepUnsent(Outgoing message);
+
+        /**
+         * message copied into a recycled buffer, so queueing doesn't allocate once the session
+         * has sent a few of each.
+         */
+        Outgoing MakeOutgoing(const std::string &message, WireFormat format, SendClass send_class, bool keep);
+
+        /**
+         * Hands a sent or dropped message's buffer back for MakeOutgoing.
+         */
+        void Recycle(std::string buffer);
+
+        std::string url_;
+
+        std::string token_;
+
+        GameMessageDecoder *decoder_;
+
+        SocketFactory make_socket_;
+
+        ReconnectSettings settings_;
+
+        WebSocketImpl::Ptr socket_;
+
+        std::uint64_t generation_{0};
+
+        Status status_{Status::Connecting};
+
+        moodycamel::ConcurrentQueue<Event> events_; // From socket callbacks
+
+        std::array<std::vector<Outgoing>, SEND_CLASSES> outbox_; // While open, until the next Flush()
+
+        std::deque<Outgoing> unsent_; // While not open, in the order queued
+
+        std::vector<std::string> spare_buffers_; // Message buffers already sent, for reuse
+
+        std::array<LatencyRecorder, SEND_CLASSES> send_latency_;
+
+        std::array<size_t, SEND_CLASSES> sent_{};
+
+        size_t coalesced_polls_{0};
+
+        float now_{0};
+
+        float retry_at_{0};
+
+        float dropped_at_{0};
+
+        float last_reconnect_{0};
+
+        int attempt_{0};
+
+        std::string last_error_;
+
+        bool ever_opened_{false};
+
+        bool reconnected_{false};
+
+        std::minstd_rand rng_;
+
+        size_t drops_{0};
+
+        size_t reconnects_{0};
+
+        size_t discarded_{0};
+
+        LatencyRecorder reconnect_times_ = LatencyRecorder::Window(64);
+
+        std::atomic<bool> measure_resync_{false};
+
+        std::atomic<size_t> resync_bytes_{0};
+    };
+
+    const char *to_string(GameSession::Status status);
+
+    const char *to_string(GameSession::SendClass send_class);
+}
@@ -0,0 +1,78 @@
+#include "poll_scheduler.h"
+
+using namespace scrabble;
+
+namespace {
+    // Responses the server never sends (dropped POLLs) shouldn't pile up forever
+    constexpr size_t MAX_IN_FLIGHT = 32;
+}
+
+PollScheduler::PollScheduler(const PollSettings settings) : settings_(settings) {
+}
+
+void PollScheduler::Reset() {
+    now_ = 0;
+    since_poll_ = 0;
+    last_change_ = 0;
+    push_active_ = false;
+    poll_now_ = false;
+    in_flight_.clear();
+}
+
+bool PollScheduler::Tick(const float delta_time) {
+    now_ += delta_time;
+    since_poll_ += delta_time;
+    if (since_poll_ < Interval() && !poll_now_) return false;
+    since_poll_ = 0;
+    poll_now_ = false;
+    polls_sent_++;
+    in_flight_.push_back(now_);
+    if (in_flight_.size() > MAX_IN_FLIGHT) in_flight_.pop_front();
+    return true;
+}
+
+void PollScheduler::OnResponse(const bool pushed, const bool changed) {
+    if (pushed) {
+        pushes_++;
+        push_active_ = true;
+    } else if (!in_flight_.empty()) {
+        round_trips_.Record(static_cast<double>(now_ - in_flight_.front()) * 1000.0);
+        in_flight_.pop_front();
+        if (changed && push_active_) {
+            // A change we only learned about by asking
+            push_active_ = false;
+        }
+    }
+    if (changed) last_change_ = now_;
+}
+
+void PollScheduler::PollNow() {
+    if (in_flight_.empty()) poll_now_ = true;
+}
+
+PollScheduler::Mode PollScheduler::CurrentMode() const {
+    if (push_active_) return Mode::Push;
+    if (lobby_) return Mode::Lobby;
+    if (buzzing_ || now_ - last_change_ < settings_.idle_after) return Mode::Active;
+    return Mode::Idle;
+}
+
+float PollScheduler::Interval() const {
+    switch (CurrentMode()) {
+        case Mode::Push: return settings_.push_keepalive_interval;
+        case Mode::Lobby: return settings_.lobby_interval;
+        case Mode::Active: return settings_.active_interval;
+        case Mode::Idle: return settings_.idle_interval;
+    }
+    return settings_.active_interval;
+}
+
+const char *scrabble::to_string(const PollScheduler::Mode mode) {
+    switch (mode) {
+        case PollScheduler::Mode::Lobby: return "lobby";
+        case PollScheduler::Mode::Active: return "active";
+        case PollScheduler::Mode::Idle: return "idle";
+        case PollScheduler::Mode::Push: return "push";
+    }
+    return "?";
+}
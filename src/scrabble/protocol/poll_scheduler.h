@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "util/stats/latency_recorder.h"
+
+namespace scrabble {
+    /**
+     * Seconds.
+     */
+    struct PollSettings {
+        float active_interval = 0.1f;
+        float idle_interval = 0.5f;
+        float lobby_interval = 1.0f;
+        float push_keepalive_interval = 5.0f;
+        float idle_after = 3.0f; // Without a change before polling slows down
+    };
+
+    /**
+     * Decides when the game socket should POLL. Fast while the game is moving (recent changes, a
+     * buzz in progress), slower when idle or in the lobby, and only a slow keepalive once the
+     * server has shown it pushes changes on its own. A keepalive that turns up a change push
+     * didn't deliver means push isn't working, and polling resumes.
+     */
+    class PollScheduler {
+    public:
+        enum class Mode {
+            Lobby, Active, Idle, Push
+        };
+
+        explicit PollScheduler(PollSettings settings = {});
+
+        /**
+         * New connection: forget push support and in-flight polls, poll fast.
+         */
+        void Reset();
+
+        /**
+         * Advances the clock. Returns true when a POLL is due, and counts it as sent.
+         */
+        bool Tick(float delta_time);
+
+        void SetLobby(const bool lobby) { lobby_ = lobby; }
+
+        void SetBuzzing(const bool buzzing) { buzzing_ = buzzing; }
+
+        /**
+         * Makes the next Tick send a POLL whatever the mode, unless one is already waiting for its
+         * answer. For getting back in sync without waiting out a push keepalive.
+         */
+        void PollNow();
+
+        /**
+         * Call for every response. pushed: the server sent it unprompted. changed: its hashCode
+         * differs from the state we had.
+         */
+        void OnResponse(bool pushed, bool changed);
+
+        [[nodiscard]] Mode CurrentMode() const;
+
+        [[nodiscard]] float Interval() const;
+
+        [[nodiscard]] bool PushActive() const { return push_active_; }
+
+        [[nodiscard]] float SinceLastChange() const { return now_ - last_change_; }
+
+        [[nodiscard]] size_t PollsSent() const { return polls_sent_; }
+
+        [[nodiscard]] size_t Pushes() const { return pushes_; }
+
+        /**
+         * POLL send to response, over the last few hundred polls.
+         */
+        LatencyRecorder &RoundTrips() { return round_trips_; }
+
+    private:
+        PollSettings settings_;
+
+        float now_{0};
+
+        float since_poll_{0};
+
+        float last_change_{0};
+
+        bool lobby_{false};
+
+        bool buzzing_{false};
+
+        bool push_active_{false};
+
+        bool poll_now_{false};
+
+        size_t polls_sent_{0};
+
+        size_t pushes_{0};
+
+        std::deque<float> in_flight_; // Send times of POLLs not yet answered, oldest first
+
+        LatencyRecorder round_trips_ = LatencyRecorder::Window(256);
+    };
+
+    const char *to_string(PollScheduler::Mode mode);
+}
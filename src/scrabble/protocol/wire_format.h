@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+namespace scrabble {
+    /**
+     * Encoding of game socket messages after the token. The client asks for one in the socket
+     * URL; a server that doesn't know the query keeps answering in JSON text frames, and the
+     * client only switches its own sends once a binary frame has arrived.
+     */
+    enum class WireFormat {
+        Json, MessagePack
+    };
+
+    /**
+     * Query string requesting format on the socket URL, empty for JSON.
+     */
+    inline std::string wire_query(const WireFormat format) {
+        return format == WireFormat::MessagePack ? "?wire=msgpack" : "";
+    }
+}
@@ -0,0 +1,379 @@
+#include "stand_in_server.h"
+
+#include <algorithm>
+#include <ctime>
+
+#include "scrabble/actions/apply_actions.h"
+#include "scrabble/protocol/clock_sync.h"
+#include "scrabble/protocol/game_delta.h"
+
+using namespace scrabble;
+using namespace scrabble::tools;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::string encode(const nlohmann::json &json, const WireFormat format) {
+        if (format == WireFormat::Json) return json.dump();
+        std::string out;
+        nlohmann::json::to_msgpack(json, nlohmann::detail::output_adapter<char>(out));
+        return out;
+    }
+
+    std::string utc_timestamp() {
+        const std::time_t now = std::time(nullptr);
+        std::tm tm{};
+#if defined(_WIN32)
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return text;
+    }
+
+    MultiplayerGame lobby_game(const std::string &id, const StandInSettings &settings) {
+        MultiplayerGame game;
+        game.id = id;
+        game.phase = "CREATED";
+        game.state = GameState{0, settings.word_minimum_size, 0, {}, settings.dictionary, {}};
+        return game;
+    }
+}
+
+std::string_view tools::api_path(std::string_view uri) {
+    if (const auto at = uri.find("/ws/"); at != std::string_view::npos) uri.remove_prefix(at + 4);
+    while (uri.starts_with('/')) uri.remove_prefix(1);
+    return uri;
+}
+
+StandInServer::StandInServer(const unsigned seed, StandInSettings settings, std::unordered_set<std::string> words)
+    : settings_(std::move(settings)), words_(std::move(words)), rng_(seed) {
+}
+
+bool StandInServer::Open(const ConnectionId id, std::string_view path) {
+    std::string_view query;
+    if (const auto at = path.find('?'); at != std::string_view::npos) {
+        query = path.substr(at + 1);
+        path = path.substr(0, at);
+    }
+    Connection connection{};
+    if (path == "account/login") {
+        connection.endpoint = Endpoint::Login;
+    } else if (path == "account/tokenAuth") {
+        connection.endpoint = Endpoint::TokenAuth;
+    } else if (path == "multiplayer/create") {
+        connection.endpoint = Endpoint::Create;
+    } else if (path.starts_with("multiplayer/v2/")) {
+        connection.endpoint = Endpoint::Game;
+        connection.game_id = std::string(path.substr(15));
+        connection.format = query.find("wire=msgpack") != std::string_view::npos ? WireFormat::MessagePack
+                                                                                 : WireFormat::Json;
+    } else {
+        return false;
+    }
+    std::lock_guard lock(mutex_);
+    if (connection.endpoint == Endpoint::Game) {
+        const auto game = games_.find(connection.game_id);
+        if (game == games_.end()) return false;
+        game->second.connections.push_back(id);
+    }
+    connections_.emplace(id, std::move(connection));
+    stats_.connections++;
+    return true;
+}
+
+void StandInServer::Close(const ConnectionId id) {
+    std::lock_guard lock(mutex_);
+    const auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    if (const auto game = games_.find(it->second.game_id); game != games_.end()) {
+        std::erase(game->second.connections, id);
+    }
+    connections_.erase(it);
+    stats_.connections--;
+}
+
+void StandInServer::Receive(const ConnectionId id, const std::string &message, const bool binary,
+                            std::vector<Outgoing> &out) {
+    std::lock_guard lock(mutex_);
+    const auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    if (it->second.endpoint == Endpoint::Game) ReceiveGame(id, it->second, message, binary, out);
+    else ReceiveAccount(id, it->second, message, out);
+}
+
+StandInServer::Stats StandInServer::GetStats() {
+    std::lock_guard lock(mutex_);
+    auto stats = stats_;
+    stats.users = accounts_.size();
+    stats.games = games_.size();
+    return stats;
+}
+
+void StandInServer::ReceiveAccount(const ConnectionId id, Connection &connection, const std::string &message,
+                                   std::vector<Outgoing> &out) {
+    auto user_reply = [&](const Account *account, const std::string &error) {
+        const UserResponse response{account != nullptr, error,
+                                    account != nullptr ? std::optional(account->user) : std::nullopt};
+        out.push_back({id, serialize(response), false});
+    };
+    switch (connection.endpoint) {
+        case Endpoint::Login: {
+            UserLoginAttempt attempt;
+            try {
+                attempt = deserialize<UserLoginAttempt>(message);
+            } catch (const nlohmann::json::exception &) {
+                user_reply(nullptr, "malformed login");
+                return;
+            }
+            if (const auto known = user_ids_.find(attempt.username); known != user_ids_.end()) {
+                const auto &account = accounts_.at(known->second);
+                if (account.password != attempt.password) user_reply(nullptr, "wrong password");
+                else user_reply(&account, "");
+                return;
+            }
+            const int user_id = static_cast<int>(accounts_.size()) + 1;
+            auto &account = accounts_[user_id];
+            account.user = User{user_id, attempt.username, RandomId(32), "", "", std::nullopt};
+            account.password = attempt.password;
+            user_ids_[attempt.username] = user_id;
+            token_ids_[account.user.token] = user_id;
+            user_reply(&account, "");
+            return;
+        }
+        case Endpoint::TokenAuth: {
+            const auto *account = FindByToken(message);
+            user_reply(account, account != nullptr ? "" : "unknown token");
+            return;
+        }
+        case Endpoint::Create: {
+            auto *account = FindByToken(message);
+            if (account == nullptr) {
+                out.push_back({id, serialize(MultiplayerActionResponse{false, std::nullopt, 0, "unknown token"}),
+                               false});
+                return;
+            }
+            auto game_id = RandomId(8);
+            auto &game = games_[game_id];
+            game.game = lobby_game(game_id, settings_);
+            game.game.playerIds.push_back(account->user.id);
+            game.game.playerNames.push_back(account->user.username);
+            game.history.emplace_back(game.hash, game.game);
+            account->user.currentGame = game_id;
+            out.push_back({id, serialize(MultiplayerActionResponse{true, game.game, game.hash, ""}), false});
+            return;
+        }
+        case Endpoint::Game:
+            return;
+    }
+}
+
+void StandInServer::ReceiveGame(const ConnectionId id, Connection &connection, const std::string &message,
+                                const bool binary, std::vector<Outgoing> &out) {
+    auto &game = games_.at(connection.game_id);
+    ExpireBuzz(game, out);
+    if (!connection.user_id.has_value()) {
+        const auto *account = FindByToken(message);
+        if (account == nullptr) {
+            Reply(id, connection, game, {false, std::nullopt, game.hash, "unknown token"}, out);
+            return;
+        }
+        connection.user_id = account->user.id;
+        auto &ids = game.game.playerIds;
+        if (game.game.phase == "CREATED" && std::ranges::find(ids, account->user.id) == ids.end()) {
+            ids.push_back(account->user.id);
+            game.game.playerNames.push_back(account->user.username);
+            accounts_.at(account->user.id).user.currentGame = connection.game_id;
+            Changed(game, out);
+        }
+        return;
+    }
+
+    MultiplayerAction action;
+    try {
+        action = binary ? deserialize_msgpack<MultiplayerAction>(message) : deserialize<MultiplayerAction>(message);
+    } catch (const nlohmann::json::exception &e) {
+        stats_.rejected++;
+        Reply(id, connection, game, {false, std::nullopt, game.hash, std::string("malformed action: ") + e.what()},
+              out);
+        return;
+    }
+    stats_.actions++;
+    if (action.actionType == "POLL") {
+        Poll(id, connection, game, action.data, out);
+        return;
+    }
+    if (action.actionType == "SUBSCRIBE") {
+        connection.subscribed = true;
+        return;
+    }
+    const auto &account = accounts_.at(*connection.user_id);
+    const auto &ids = game.game.playerIds;
+    const auto player = std::ranges::find(ids, account.user.id);
+    if (player == ids.end()) {
+        stats_.rejected++;
+        Reply(id, connection, game, {false, std::nullopt, game.hash, "not a player in this game"}, out);
+        return;
+    }
+    if (auto error = Apply(game, account, static_cast<int>(player - ids.begin()), action)) {
+        stats_.rejected++;
+        Reply(id, connection, game, {false, std::nullopt, game.hash, std::move(*error)}, out);
+        return;
+    }
+    Changed(game, out);
+}
+
+std::optional<std::string> StandInServer::Apply(Game &game, const Account &account, const int player_index,
+                                                MultiplayerAction &action) {
+    auto &current = game.game;
+    const auto &type = action.actionType;
+    if (type == "CHAT") {
+        current.chat.push_back({account.user.username, utc_timestamp(), action.data});
+        return std::nullopt;
+    }
+    if (type == "START") {
+        if (current.phase != "CREATED") return "game already started";
+        current.state = new_game_state(rng_, static_cast<int>(current.playerIds.size()), settings_.word_minimum_size,
+                                       settings_.dictionary);
+        current.phase = "ONGOING";
+        return std::nullopt;
+    }
+    if (current.phase != "ONGOING") return "game is not in progress";
+    if (type == "END") {
+        current.phase = "FINISHED";
+        current.buzzHolder.reset();
+        current.buzzElapsed.reset();
+        for (const int id: current.playerIds) accounts_.at(id).user.currentGame.reset();
+        return std::nullopt;
+    }
+    if (type == "BUZZ") {
+        if (current.buzzHolder.has_value() && *current.buzzHolder != player_index) return "someone else buzzed";
+        current.buzzHolder = player_index;
+        current.buzzElapsed = 0;
+        game.buzz_at = Clock::now();
+        return std::nullopt;
+    }
+    if (type != "ACTION") return "unknown action type " + type;
+    if (!action.action.has_value()) return "ACTION without an action";
+    auto &update = *action.action;
+    update.actingPlayer = player_index; // Whatever the client claims
+    if (update.actionType == "FLIP") {
+        if (!apply_flip(current.state, update.flippedTileId)) return "no face-down tile " + update.flippedTileId;
+    } else if (update.actionType == "CLAIM") {
+        if (current.buzzHolder.has_value() && *current.buzzHolder != player_index) return "someone else buzzed";
+        if (!words_.empty() && !words_.contains(update.claimWord)) return update.claimWord + " is not a word";
+        if (!apply_claim(current.state, update, "w" + std::to_string(game.next_word_id))) {
+            return "can't make " + update.claimWord;
+        }
+        game.next_word_id++;
+        current.buzzHolder.reset();
+        current.buzzElapsed.reset();
+    } else {
+        return "unknown action " + update.actionType;
+    }
+    current.lastAction = update;
+    return std::nullopt;
+}
+
+void StandInServer::Changed(Game &game, std::vector<Outgoing> &out) {
+    const int base_hash = game.hash;
+    game.hash++;
+    game.history.emplace_back(game.hash, game.game);
+    while (game.history.size() > std::max<size_t>(settings_.history, 2)) game.history.pop_front();
+
+    // One encoding per format, shared by every subscriber
+    const auto &previous = game.history[game.history.size() - 2].second;
+    nlohmann::json push;
+    if (auto delta = MakeDelta(game, previous, base_hash)) {
+        push = GameDeltaResponse{true, std::move(*delta), game.hash, ""};
+        stats_.deltas++;
+    } else {
+        push = MultiplayerActionResponse{true, game.game, game.hash, ""};
+        stats_.snapshots++;
+    }
+    push["push"] = true;
+    Stamp(push, game);
+    std::optional<std::string> encoded[2];
+    for (const auto id: game.connections) {
+        const auto &connection = connections_.at(id);
+        if (!connection.subscribed) continue;
+        auto &payload = encoded[static_cast<int>(connection.format)];
+        if (!payload.has_value()) payload = encode(push, connection.format);
+        out.push_back({id, *payload, connection.format == WireFormat::MessagePack});
+        stats_.pushes++;
+    }
+}
+
+void StandInServer::ExpireBuzz(Game &game, std::vector<Outgoing> &out) {
+    if (!game.game.buzzHolder.has_value() || Clock::now() - game.buzz_at < settings_.buzz_timeout) return;
+    game.game.buzzHolder.reset();
+    game.game.buzzElapsed.reset();
+    Changed(game, out);
+}
+
+int StandInServer::BuzzElapsed(const Game &game) const {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - game.buzz_at);
+    return static_cast<int>(elapsed.count());
+}
+
+std::optional<GameDelta> StandInServer::MakeDelta(const Game &game, const MultiplayerGame &base,
+                                                  const int base_hash) const {
+    if (!game.game.buzzHolder.has_value()) return make_game_delta(base, game.game, base_hash);
+    auto live = game.game;
+    live.buzzElapsed = BuzzElapsed(game);
+    return make_game_delta(base, live, base_hash);
+}
+
+void StandInServer::Stamp(nlohmann::json &message, const Game &game, const std::optional<std::int64_t> poll_sent) const {
+    message["serverTime"] = wall_millis();
+    if (poll_sent.has_value()) message["pollSent"] = *poll_sent;
+    if (!game.game.buzzHolder.has_value()) return;
+    if (const auto it = message.find("game"); it != message.end() && it->is_object()) {
+        (*it)["buzzElapsed"] = BuzzElapsed(game);
+    }
+}
+
+void StandInServer::Reply(const ConnectionId id, const Connection &connection, const Game &game,
+                          const MultiplayerActionResponse &response, std::vector<Outgoing> &out,
+                          const std::optional<std::int64_t> poll_sent) {
+    nlohmann::json message = response;
+    Stamp(message, game, poll_sent);
+    out.push_back({id, encode(message, connection.format), connection.format == WireFormat::MessagePack});
+}
+
+void StandInServer::Poll(const ConnectionId id, const Connection &connection, const Game &game,
+                         const std::string &data, std::vector<Outgoing> &out) {
+    const auto poll_sent = parse_poll_sent(data);
+    if (const auto base_hash = parse_delta_poll_data(data)) {
+        const auto base = std::ranges::find_if(game.history, [&](const auto &entry) {
+            return entry.first == *base_hash;
+        });
+        if (base != game.history.end()) {
+            if (auto delta = MakeDelta(game, base->second, *base_hash)) {
+                nlohmann::json response = GameDeltaResponse{true, std::move(*delta), game.hash, ""};
+                Stamp(response, game, poll_sent);
+                out.push_back({id, encode(response, connection.format),
+                               connection.format == WireFormat::MessagePack});
+                stats_.deltas++;
+                return;
+            }
+        }
+    }
+    Reply(id, connection, game, {true, game.game, game.hash, ""}, out, poll_sent);
+    stats_.snapshots++;
+}
+
+StandInServer::Account *StandInServer::FindByToken(const std::string &token) {
+    const auto it = token_ids_.find(token);
+    return it != token_ids_.end() ? &accounts_.at(it->second) : nullptr;
+}
+
+std::string StandInServer::RandomId(const size_t length) {
+    static constexpr char ALPHABET[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(ALPHABET) - 2);
+    std::string id(length, ' ');
+    for (auto &c: id) c = ALPHABET[pick(rng_)];
+    return id;
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "scrabble/context/types.h"
+#include "scrabble/protocol/game_delta.h"
+#include "scrabble/protocol/wire_format.h"
+
+namespace scrabble::tools {
+    struct StandInSettings {
+        int word_minimum_size = 3;
+        std::string dictionary = "STANDIN"; // GameState::dictionary; clients load a .dawg by this name if they have one
+        std::chrono::milliseconds buzz_timeout{5000}; // A buzz nobody follows up with a CLAIM lapses
+        size_t history = 32; // Snapshots kept per game to answer POLLs with deltas
+    };
+
+    /**
+     * A frame for the transport to send.
+     */
+    struct Outgoing {
+        std::uint64_t connection;
+        std::string payload;
+        bool binary;
+    };
+
+    /**
+     * The API server's protocols, without the network: what pirate-scrabble-server runs behind
+     * IXWebSocket. Paths are the part of the socket URL after /ws/:
+     *
+     *   account/login        UserLoginAttempt -> UserResponse; unknown usernames are registered
+     *   account/tokenAuth    token -> UserResponse
+     *   multiplayer/create   token -> MultiplayerActionResponse with the new game, phase CREATED
+     *   multiplayer/v2/<id>  token, then MultiplayerActions; ?wire=msgpack switches replies to
+     *                        binary MessagePack frames
+     *
+     * Account connections answer every message, so they can be kept open. On a game socket, the
+     * token joins the game while it is in the lobby. POLL is answered with a snapshot, or a
+     * GameDeltaResponse if its data acknowledges a hash still in the history. Every change is
+     * pushed ("push": true, as a delta against the previous hash) to connections that sent
+     * SUBSCRIBE; other actions get no reply of their own unless they are rejected. Every game
+     * socket message carries serverTime (epoch milliseconds), POLL replies echo the POLL's sent=
+     * field as pollSent, and buzzElapsed is worked out as of serverTime.
+     *
+     * Game actions are POLL, SUBSCRIBE, START, BUZZ, CHAT, END, and ACTION carrying a FLIP or
+     * CLAIM GameStateUpdate. Claims are checked with apply_claim, and against words if it isn't
+     * empty. All methods are safe to call from the transport's threads.
+     */
+    class StandInServer {
+    public:
+        using ConnectionId = std::uint64_t;
+
+        struct Stats {
+            size_t connections;
+            size_t users;
+            size_t games;
+            size_t actions;
+            size_t rejected;
+            size_t snapshots;
+            size_t deltas;
+            size_t pushes;
+        };
+
+        explicit StandInServer(unsigned seed, StandInSettings settings = {},
+                               std::unordered_set<std::string> words = {});
+
+        /**
+         * A socket opened on path. False if there is no such endpoint.
+         */
+        bool Open(ConnectionId id, std::string_view path);
+
+        /**
+         * A frame from id; replies and pushes are appended to out.
+         */
+        void Receive(ConnectionId id, const std::string &message, bool binary, std::vector<Outgoing> &out);
+
+        void Close(ConnectionId id);
+
+        [[nodiscard]] Stats GetStats();
+
+    private:
+        enum class Endpoint {
+            Login, TokenAuth, Create, Game
+        };
+
+        struct Connection {
+            Endpoint endpoint;
+            std::string game_id;
+            WireFormat format{WireFormat::Json};
+            std::optional<int> user_id; // Game sockets, once the token has been accepted
+            bool subscribed{false};
+        };
+
+        struct Account {
+            User user;
+            std::string password;
+        };
+
+        struct Game {
+            MultiplayerGame game;
+            int hash{1};
+            std::deque<std::pair<int, MultiplayerGame> > history; // Oldest first, current last
+            std::vector<ConnectionId> connections;
+            int next_word_id{0};
+            std::chrono::steady_clock::time_point buzz_at;
+        };
+
+        void ReceiveAccount(ConnectionId id, Connection &connection, const std::string &message,
+                            std::vector<Outgoing> &out);
+
+        void ReceiveGame(ConnectionId id, Connection &connection, const std::string &message, bool binary,
+                         std::vector<Outgoing> &out);
+
+        /**
+         * Applies action for player_index. Returns an error message if it was rejected.
+         */
+        std::optional<std::string> Apply(Game &game, const Account &account, int player_index,
+                                         MultiplayerAction &action);
+
+        /**
+         * Records the new state under a new hash and pushes it to subscribers.
+         */
+        void Changed(Game &game, std::vector<Outgoing> &out);
+
+        void ExpireBuzz(Game &game, std::vector<Outgoing> &out);
+
+        /**
+         * Milliseconds since the running buzz started.
+         */
+        [[nodiscard]] int BuzzElapsed(const Game &game) const;
+
+        /**
+         * make_game_delta from base to the game as it is now, running buzzElapsed included, so the
+         * delta's digest covers it.
+         */
+        [[nodiscard]] std::optional<GameDelta> MakeDelta(const Game &game, const MultiplayerGame &base,
+                                                         int base_hash) const;
+
+        /**
+         * Stamps message with serverTime (and pollSent, if given) and, in a snapshot, the current
+         * buzzElapsed.
+         */
+        void Stamp(nlohmann::json &message, const Game &game, std::optional<std::int64_t> poll_sent = {}) const;
+
+        void Reply(ConnectionId id, const Connection &connection, const Game &game,
+                   const MultiplayerActionResponse &response, std::vector<Outgoing> &out,
+                   std::optional<std::int64_t> poll_sent = {});
+
+        void Poll(ConnectionId id, const Connection &connection, const Game &game, const std::string &data,
+                  std::vector<Outgoing> &out);
+
+        Account *FindByToken(const std::string &token);
+
+        std::string RandomId(size_t length);
+
+        std::mutex mutex_;
+
+        StandInSettings settings_;
+
+        std::unordered_set<std::string> words_;
+
+        std::mt19937 rng_;
+
+        std::unordered_map<ConnectionId, Connection> connections_;
+
+        std::map<int, Account> accounts_;
+
+        std::unordered_map<std::string, int> user_ids_; // By username
+
+        std::unordered_map<std::string, int> token_ids_;
+
+        std::unordered_map<std::string, Game> games_;
+
+        Stats stats_{};
+    };
+
+    /**
+     * The path part of a socket URI after /ws/, e.g. "multiplayer/v2/abc?wire=msgpack" for
+     * "/ws/multiplayer/v2/abc?wire=msgpack".
+     */
+    std::string_view api_path(std::string_view uri);
+}
@@ -0,0 +1,82 @@
+#include "synthetic_game.h"
+
+#include <algorithm>
+
+#include "scrabble/actions/tile_bag.h"
+#include "scrabble/dictionary/dawg.h"
+#include "scrabble/dictionary/dawg_builder.h"
+
+using namespace scrabble;
+
+std::vector<std::string> tools::synthetic_word_list(std::mt19937 &rng, const size_t count) {
+    std::discrete_distribution<int> letter(std::begin(TILE_DISTRIBUTION), std::end(TILE_DISTRIBUTION));
+    std::uniform_int_distribution<int> length(2, 9);
+    std::vector<std::string> words;
+    words.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string word(static_cast<size_t>(length(rng)), 'A');
+        for (auto &c: word) c = static_cast<char>('A' + letter(rng));
+        words.push_back(std::move(word));
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+bool tools::load_word_list(const std::string &path, std::vector<std::string> &out) {
+    out.clear();
+    if (path.ends_with(".dawg")) {
+        Dictionary dictionary;
+        if (!dictionary.Open(path)) return false;
+        out.reserve(dictionary.WordCount());
+        dictionary.ForEachWord([&out](const std::string_view word) { out.emplace_back(word); });
+        return true;
+    }
+    // Go through the builder so plain lists get the same cleanup as dict-build
+    DawgBuilder builder;
+    if (!read_word_list(path, builder)) return false;
+    out = builder.SortedWords();
+    return true;
+}
+
+GameState tools::synthetic_board(std::mt19937 &rng,
+                                 const std::vector<std::string> &words,
+                                 const int players,
+                                 const int claimed_words,
+                                 const int face_up) {
+    GameState game{};
+    game.wordMinimumSize = 3;
+    game.playerCount = players;
+    game.dictionary = "SYNTHETIC";
+    game.playerWords.resize(static_cast<size_t>(players));
+
+    std::vector<char> bag;
+    bag.reserve(TILE_TOTAL);
+    for (int letter = 0; letter < LETTER_COUNT; letter++) {
+        bag.insert(bag.end(), static_cast<size_t>(TILE_DISTRIBUTION[letter]), static_cast<char>('A' + letter));
+    }
+    std::shuffle(bag.begin(), bag.end(), rng);
+
+    // Claim words whose letters are still in the bag
+    LetterHistogram remaining;
+    for (const char c: bag) remaining.Add(c);
+    std::uniform_int_distribution<size_t> pick(0, words.empty() ? 0 : words.size() - 1);
+    int word_id = 0;
+    for (int attempt = 0; word_id < claimed_words && attempt < claimed_words * 200 && !words.empty(); attempt++) {
+        const auto &word = words[pick(rng)];
+        if (static_cast<int>(word.size()) < game.wordMinimumSize) continue;
+        const auto letters = LetterHistogram::FromWord(word);
+        if (!letters.IsSubsetOf(remaining)) continue;
+        remaining = remaining.SaturatingSubtract(letters);
+        for (const char c: word) bag.erase(std::find(bag.begin(), bag.end(), c));
+        game.playerWords[static_cast<size_t>(word_id % players)].push_back(Word{{word}, "w" + std::to_string(word_id)});
+        word_id++;
+    }
+
+    const size_t flipped = face_up < 0 ? bag.size() : std::min(bag.size(), static_cast<size_t>(face_up));
+    for (size_t i = 0; i < bag.size(); i++) {
+        game.tiles.push_back(TileProps{std::string(1, bag[i]), "t" + std::to_string(i), i < flipped});
+    }
+    game.tileCount = static_cast<int>(game.tiles.size());
+    return game;
+}
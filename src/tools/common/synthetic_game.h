@@ -0,0 +1,33 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "scrabble/context/types.h"
+
+/**
+ * Synthetic inputs for the command line benchmarks, so they run without a real word list or server.
+ */
+namespace scrabble::tools {
+    /**
+     * Random letter strings of length 2-9 drawn with tile frequencies. Not English, but with a
+     * realistic letter mix and roughly the size and length profile of a tournament word list.
+     */
+    std::vector<std::string> synthetic_word_list(std::mt19937 &rng, size_t count);
+
+    /**
+     * Loads a compiled .dawg or a plain one-word-per-line list. Returns false if it can't be read.
+     */
+    bool load_word_list(const std::string &path, std::vector<std::string> &out);
+
+    /**
+     * A mid/late game board: claimed_words words spread over players, made from tiles taken out
+     * of a 144 tile bag, and face_up of the remaining tiles flipped (-1 for all of them).
+     */
+    GameState synthetic_board(std::mt19937 &rng,
+                              const std::vector<std::string> &words,
+                              int players,
+                              int claimed_words,
+                              int face_up);
+}
@@ -0,0 +1,328 @@
+// decode-bench: times game socket message decoding, DOM (deserialize<T>) against streaming
+// (stream_deserialize) and MessagePack (deserialize_msgpack), on a recorded or generated session.
+//
+//   decode-bench [--payloads <file>] [--capture <file>] [--record <file>] [--games N] [--players N]
+//                [--rounds N] [--seed N]
+//
+// --payloads reads one message per line, as received on the game socket. --capture takes what
+// game sockets received from a capture recorded with PIRATE_SCRABBLE_RECORD, MessagePack frames
+// turned back into JSON, so a real game can be benchmarked offline. Without either, --games
+// solver-played games are recorded the way a polling client sees them: a full snapshot after
+// every action, plus the delta from the previous one. --record writes what was generated in the
+// --payloads format. Every message is decoded --rounds times per mode; the streaming and
+// MessagePack results are checked against the DOM ones before timing. The MessagePack frames are
+// what a server answering ?wire=msgpack would send for the same messages; encode times for both
+// formats are the server's side of the cost.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+#include "fmt/core.h"
+
+#include "scrabble/actions/anagram_index.h"
+#include "scrabble/actions/apply_actions.h"
+#include "scrabble/actions/solver.h"
+#include "scrabble/context/types.h"
+#include "scrabble/protocol/envelope_scan.h"
+#include "scrabble/protocol/game_delta.h"
+#include "tools/common/synthetic_game.h"
+#include "util/network/socket_capture.h"
+#include "util/serialization/stream_decode.h"
+#include "util/stats/latency_recorder.h"
+
+using namespace scrabble;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Payload {
+        std::string text;
+        bool delta;
+        std::string binary; // The same message as MessagePack
+    };
+
+    MultiplayerGame wrap(const GameState &state, const int players) {
+        MultiplayerGame game;
+        game.id = "bench";
+        game.phase = "ONGOING";
+        game.state = state;
+        for (int i = 0; i < players; i++) {
+            game.playerIds.push_back(i + 1);
+            game.playerNames.push_back("player " + std::to_string(i + 1));
+        }
+        return game;
+    }
+
+    /**
+     * Plays one game with the solver and records what a polling client would receive.
+     */
+    void record_game(std::mt19937 &rng, const AnagramIndex &index, const int players, std::vector<Payload> &out) {
+        auto state = new_game_state(rng, players, 3, "BENCH");
+        auto game = wrap(state, players);
+        int hash = 0;
+        int word_id = 0;
+        std::vector<Claim> claims;
+        std::uniform_int_distribution<int> chat(0, 7);
+        auto emit = [&](MultiplayerGame next) {
+            const int next_hash = hash + 1;
+            if (auto delta = make_game_delta(game, next, hash)) {
+                const GameDeltaResponse response{
+                    .ok = true, .delta = std::move(*delta), .hashCode = next_hash, .errorMessage = ""
+                };
+                out.push_back({serialize(response), true, ""});
+            }
+            const MultiplayerActionResponse response{
+                .ok = true, .game = next, .hashCode = next_hash, .errorMessage = ""
+            };
+            out.push_back({serialize(response), false, ""});
+            game = std::move(next);
+            hash = next_hash;
+        };
+        while (true) {
+            auto next = game;
+            if (chat(rng) == 0) {
+                next.chat.push_back({next.playerNames[0], "2025-01-01T00:00:00Z", "nice \"steal\" é"});
+            }
+            claims.clear();
+            solve_claims(next.state, index, claims);
+            if (!claims.empty()) {
+                const auto &best = claims.front();
+                GameStateUpdate claim{"CLAIM", "", std::string(best.word), best.stolen ? best.stolen->id : "",
+                                      static_cast<int>(word_id % players),
+                                      best.stolen ? std::optional(best.player) : std::nullopt};
+                if (apply_claim(next.state, claim, "w" + std::to_string(word_id++))) {
+                    next.lastAction = claim;
+                    emit(std::move(next));
+                    continue;
+                }
+            }
+            const int tile = next_face_down(next.state);
+            if (tile < 0) break;
+            const auto id = next.state.tiles[static_cast<size_t>(tile)].id;
+            apply_flip(next.state, id);
+            next.lastAction = GameStateUpdate{"FLIP", id, "", "", 0, std::nullopt};
+            emit(std::move(next));
+        }
+    }
+
+    bool load_payloads(const std::string &path, std::vector<Payload> &out) {
+        std::ifstream in(path);
+        if (!in) {
+            std::cerr << "can't read " << path << "\n";
+            return false;
+        }
+        std::string line;
+        EnvelopeScan scan;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            const bool delta = scan_envelope(line, scan) && scan.has_delta;
+            out.push_back({std::move(line), delta, ""});
+        }
+        return true;
+    }
+
+    bool load_capture(const std::string &path, std::vector<Payload> &out) {
+        std::vector<CaptureRecord> records;
+        if (!read_capture(path, records)) {
+            std::cerr << "can't read capture " << path << "\n";
+            return false;
+        }
+        std::unordered_set<std::uint32_t> game_sockets;
+        EnvelopeScan scan;
+        for (auto &record: records) {
+            if (record.event == CaptureEvent::Created) {
+                if (capture_url_path(record.payload).find("/multiplayer/v2/") != std::string::npos) {
+                    game_sockets.insert(record.socket);
+                }
+                continue;
+            }
+            if (!game_sockets.contains(record.socket)) continue;
+            std::string text;
+            if (record.event == CaptureEvent::Received) {
+                text = std::move(record.payload);
+            } else if (record.event == CaptureEvent::ReceivedBinary) {
+                text = nlohmann::json::from_msgpack(record.payload).dump();
+            } else {
+                continue;
+            }
+            const bool delta = scan_envelope(text, scan) && scan.has_delta;
+            out.push_back({std::move(text), delta, ""});
+        }
+        return true;
+    }
+
+    template<typename T>
+    T dom_decode(const std::string &text) {
+        return deserialize<T>(text);
+    }
+
+    /**
+     * Streaming, MessagePack and DOM decodes must re-serialize identically. Fills in payload.binary.
+     */
+    template<typename T>
+    bool check(Payload &payload) {
+        const auto dom = dom_decode<T>(payload.text);
+        const auto expected = serialize(dom);
+        T streamed{};
+        std::string error;
+        if (!stream_deserialize(payload.text, streamed, &error)) {
+            std::cerr << "stream decode failed: " << error << "\n";
+            return false;
+        }
+        if (serialize(streamed) != expected) {
+            std::cerr << "stream decode differs from DOM decode\n";
+            return false;
+        }
+        payload.binary = serialize_msgpack(dom);
+        if (serialize(deserialize_msgpack<T>(payload.binary)) != expected) {
+            std::cerr << "MessagePack round trip differs\n";
+            return false;
+        }
+        return true;
+    }
+
+    struct Targets {
+        MultiplayerActionResponse response;
+        GameDeltaResponse delta;
+    };
+
+    enum class Mode {
+        Dom, Stream, StreamReuse, MessagePack, EncodeJson, EncodeMessagePack
+    };
+
+    void decode(const Mode mode, const Payload &payload, Targets &reused) {
+        switch (mode) {
+            case Mode::Dom:
+                if (payload.delta) (void) dom_decode<GameDeltaResponse>(payload.text);
+                else (void) dom_decode<MultiplayerActionResponse>(payload.text);
+                break;
+            case Mode::Stream: {
+                Targets fresh;
+                if (payload.delta) stream_deserialize(payload.text, fresh.delta);
+                else stream_deserialize(payload.text, fresh.response);
+                break;
+            }
+            case Mode::StreamReuse:
+                if (payload.delta) stream_deserialize(payload.text, reused.delta);
+                else stream_deserialize(payload.text, reused.response);
+                break;
+            case Mode::MessagePack:
+                if (payload.delta) (void) deserialize_msgpack<GameDeltaResponse>(payload.binary);
+                else (void) deserialize_msgpack<MultiplayerActionResponse>(payload.binary);
+                break;
+            case Mode::EncodeJson:
+                (void) (payload.delta ? serialize(reused.delta) : serialize(reused.response));
+                break;
+            case Mode::EncodeMessagePack:
+                (void) (payload.delta ? serialize_msgpack(reused.delta) : serialize_msgpack(reused.response));
+                break;
+        }
+    }
+
+    void run(const char *name, const Mode mode, const std::vector<Payload> &payloads, const int rounds,
+             const size_t bytes) {
+        LatencyRecorder latency;
+        Targets reused;
+        const bool encode = mode == Mode::EncodeJson || mode == Mode::EncodeMessagePack;
+        auto elapsed = Clock::duration::zero();
+        for (int round = 0; round < rounds; round++) {
+            for (const auto &payload: payloads) {
+                if (encode) {
+                    // What gets encoded is the decoded message; that part isn't timed
+                    if (payload.delta) stream_deserialize(payload.text, reused.delta);
+                    else stream_deserialize(payload.text, reused.response);
+                }
+                const auto t = Clock::now();
+                decode(mode, payload, reused);
+                const auto took = Clock::now() - t;
+                latency.Record(took);
+                elapsed += took;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double messages = static_cast<double>(payloads.size()) * rounds;
+        fmt::print("{:<15} {:>9.0f} msg/s {:>8.1f} MB/s  mean {:.1f}  p50 {:.1f}  p99 {:.1f} us\n",
+                   name, messages / seconds, static_cast<double>(bytes) * rounds / seconds / 1e6,
+                   latency.Mean() * 1000, latency.Percentile(50) * 1000, latency.Percentile(99) * 1000);
+    }
+}
+
+int main(const int argc, char **argv) {
+    std::string payloads_path;
+    std::string capture_path;
+    std::string record_path;
+    int games = 20;
+    int players = 4;
+    int rounds = 5;
+    unsigned seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const char *value = argv[i + 1];
+        if (flag == "--payloads") payloads_path = value;
+        else if (flag == "--capture") capture_path = value;
+        else if (flag == "--record") record_path = value;
+        else if (flag == "--games") games = std::atoi(value);
+        else if (flag == "--players") players = std::atoi(value);
+        else if (flag == "--rounds") rounds = std::max(1, std::atoi(value));
+        else if (flag == "--seed") seed = static_cast<unsigned>(std::atoi(value));
+        else {
+            std::cerr << "usage: decode-bench [--payloads file] [--capture file] [--record file] [--games N] [--players N]"
+                    " [--rounds N] [--seed N]\n";
+            return 2;
+        }
+    }
+
+    std::vector<Payload> payloads;
+    if (!payloads_path.empty()) {
+        if (!load_payloads(payloads_path, payloads)) return 1;
+    } else if (!capture_path.empty()) {
+        if (!load_capture(capture_path, payloads)) return 1;
+    } else {
+        std::mt19937 rng(seed);
+        AnagramIndex index;
+        index.Build(tools::synthetic_word_list(rng, 50000));
+        for (int g = 0; g < games; g++) record_game(rng, index, players, payloads);
+    }
+    if (!record_path.empty()) {
+        std::ofstream out(record_path);
+        for (const auto &payload: payloads) out << payload.text << "\n";
+    }
+    if (payloads.empty()) {
+        std::cerr << "no payloads\n";
+        return 1;
+    }
+
+    size_t bytes = 0;
+    size_t binary_bytes = 0;
+    size_t deltas = 0;
+    for (auto &payload: payloads) {
+        deltas += payload.delta;
+        const bool ok = payload.delta
+                            ? check<GameDeltaResponse>(payload)
+                            : check<MultiplayerActionResponse>(payload);
+        if (!ok) {
+            std::cerr << "payload: " << payload.text.substr(0, 200) << "\n";
+            return 1;
+        }
+        bytes += payload.text.size();
+        binary_bytes += payload.binary.size();
+    }
+    const auto count = static_cast<double>(payloads.size());
+    fmt::print("{} messages ({} deltas)\n", payloads.size(), deltas);
+    fmt::print("json     {:>10.1f} KB, mean {:.0f} B\n", static_cast<double>(bytes) / 1024,
+               static_cast<double>(bytes) / count);
+    fmt::print("msgpack  {:>10.1f} KB, mean {:.0f} B ({:.0f}% of json)\n", static_cast<double>(binary_bytes) / 1024,
+               static_cast<double>(binary_bytes) / count,
+               100.0 * static_cast<double>(binary_bytes) / static_cast<double>(bytes));
+
+    run("dom", Mode::Dom, payloads, rounds, bytes);
+    run("stream", Mode::Stream, payloads, rounds, bytes);
+    run("stream-reuse", Mode::StreamReuse, payloads, rounds, bytes);
+    run("msgpack", Mode::MessagePack, payloads, rounds, binary_bytes);
+    run("encode-json", Mode::EncodeJson, payloads, rounds, bytes);
+    run("encode-msgpack", Mode::EncodeMessagePack, payloads, rounds, binary_bytes);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// dict-build: compiles a plain word list (one word per line) into the memory-mappable
+// dictionary format read by scrabble::Dictionary.
+//
+//   dict-build <words.txt> <out.dawg>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "scrabble/dictionary/dawg.h"
+#include "scrabble/dictionary/dawg_builder.h"
+
+using namespace scrabble;
+
+int main(const int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <words.txt> <out.dawg>\n";
+        return 2;
+    }
+    const std::string input_path = argv[1];
+    const std::string output_path = argv[2];
+
+    const auto start = std::chrono::steady_clock::now();
+    DawgBuilder builder;
+    if (!read_word_list(input_path, builder)) return 1;
+
+    DawgBuildStats stats;
+    std::vector<unsigned char> bytes;
+    try {
+        bytes = builder.Build(&stats);
+    } catch (const std::exception &e) {
+        std::cerr << "Build failed: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open file for writing: " << output_path << "\n";
+        return 1;
+    }
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write to file: " << output_path << "\n";
+        return 1;
+    }
+    const auto built = std::chrono::steady_clock::now();
+
+    // Round trip: load what we wrote the same way the client does, and check every word is found.
+    Dictionary dictionary;
+    const auto load_start = std::chrono::steady_clock::now();
+    if (!dictionary.Open(output_path)) return 1;
+    const auto loaded = std::chrono::steady_clock::now();
+
+    std::uint32_t enumerated = 0;
+    std::uint32_t missing = 0;
+    dictionary.ForEachWord([&](const std::string_view word) {
+        enumerated++;
+        if (!dictionary.Contains(word)) missing++;
+    });
+    if (enumerated != stats.word_count || missing != 0) {
+        std::cerr << "Verification failed: " << enumerated << " words enumerated, "
+                << missing << " not found, expected " << stats.word_count << "\n";
+        return 1;
+    }
+
+    const auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+    std::cout << "words:      " << stats.word_count << " (" << stats.skipped_count << " lines skipped)\n"
+            << "nodes:      " << stats.node_count << "\n"
+            << "edges:      " << stats.edge_count << "\n"
+            << "max length: " << stats.max_word_length << "\n"
+            << "size:       " << bytes.size() << " bytes\n"
+            << "build:      " << ms(built - start) << " ms\n"
+            << "load:       " << ms(loaded - load_start) << " ms\n";
+    return 0;
+}
@@ -0,0 +1,652 @@
+// pirate-scrabble-loadgen: many headless clients playing multiplayer games against one API server.
+//
+//   pirate-scrabble-loadgen [--url ws://host:port/ws/] [--clients N] [--players N] [--duration seconds]
+//                           [--wire json|msgpack] [--action-interval seconds] [--subscribe 0|1]
+//                           [--seed N] [--allow-remote 0|1] [--network <preset|conditions.json>]
+//                           [--record <capture>]
+//
+// Meant for pirate-scrabble-server; --url defaults to $PIRATE_SCRABBLE_API, then
+// ws://127.0.0.1:8080/ws/. The production host is refused unless --allow-remote 1.
+//
+// Clients log in (user loadgen-<seed>-<i>) and form games of --players: the first of each group
+// creates the game and STARTs it once everyone has joined, and creates another when it's over.
+// Each client runs the game's own protocol stack (GameSession, GameMessageDecoder, ActionEncoder,
+// PollScheduler) and takes an action every --action-interval seconds on average: FLIP a face-down
+// tile, BUZZ, CLAIM a word made of face-up letters while holding the buzz, or CHAT. Claims are
+// only legal against a server started without --words.
+//
+// An action's round trip runs from sending it to the first state showing its effect, however that
+// state arrived (push, POLL response, delta). Actions with no visible effect after 10 s are
+// reported as unconfirmed; rejections are counted from the server's error responses.
+//
+// Each client also keeps a ClockSync on its POLLs. The summary compares its estimates with this
+// machine's own clock, which is the truth when the server runs here too.
+//
+// --network puts every client socket behind a NetworkSimulator, with one of network_presets()
+// (e.g. 3G) or conditions from a file in the game's network_conditions.json format. --record
+// captures every client's sockets into one file, for decode-bench --capture.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "fmt/core.h"
+#include "ixwebsocket/IXNetSystem.h"
+
+#include "scrabble/context/socket_client.h"
+#include "scrabble/context/types.h"
+#include "scrabble/protocol/action_encoder.h"
+#include "scrabble/protocol/clock_sync.h"
+#include "scrabble/protocol/game_message_decoder.h"
+#include "scrabble/protocol/game_session.h"
+#include "scrabble/protocol/poll_scheduler.h"
+#include "util/logging/logging.h"
+#include "util/network/connection_manager.h"
+#include "util/network/network_simulator.h"
+#include "util/network/socket_capture.h"
+#include "util/stats/latency_recorder.h"
+
+using namespace scrabble;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto UNCONFIRMED_AFTER = std::chrono::seconds(10);
+    constexpr double BUZZ_CHANCE = 0.3;
+    constexpr double CHAT_CHANCE = 0.05;
+
+    struct Options {
+        std::string url;
+        int clients = 200;
+        int players = 4;
+        double duration = 30;
+        WireFormat wire = WireFormat::Json;
+        float action_interval = 0.5f;
+        bool subscribe = true;
+        unsigned seed = 1;
+        bool allow_remote = false;
+        std::string network;
+        std::string record;
+    };
+
+    enum class ActionKind {
+        Flip, Buzz, Claim, Chat
+    };
+
+    struct PendingAction {
+        ActionKind kind;
+        std::string key; // Tile id, claimed word or chat message
+        size_t baseline; // Claims: the player's words spelling key when it was sent
+        Clock::time_point sent;
+    };
+
+    struct Group;
+
+    struct Client {
+        int index{0};
+        Group *group{nullptr};
+        std::optional<User> user;
+        bool login_failed{false};
+        GameMessageQueue inbox;
+        std::unique_ptr<GameMessageDecoder> decoder;
+        std::unique_ptr<GameSession> session; // Declared after decoder, destroyed before it
+        std::string session_game; // Game the session was opened for
+        bool greeted{false}; // SUBSCRIBE and first POLL sent on this session
+        ActionEncoder encoder;
+        PollScheduler polls;
+        ClockSync clock;
+        std::optional<MultiplayerGame> game;
+        std::optional<int> hash;
+        float until_action{0};
+        std::vector<PendingAction> pending;
+        size_t chats{0};
+    };
+
+    struct Group {
+        std::vector<Client *> members; // Leader first
+        std::string game_id;
+        bool creating{false};
+        bool started{false};
+    };
+
+    struct Totals {
+        size_t received{0};
+        size_t sent{0};
+        size_t rejected{0};
+        std::string last_rejection;
+        size_t protocol_errors{0};
+        size_t unconfirmed{0};
+        size_t games_started{0};
+        size_t games_finished{0};
+        LatencyRecorder flip{1 << 16};
+        LatencyRecorder buzz{1 << 14};
+        LatencyRecorder claim{1 << 14};
+        LatencyRecorder chat{1 << 12};
+    };
+
+    bool parse_options(const int argc, char **argv, Options &options) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string flag = argv[i];
+            const std::string value = argv[i + 1];
+            if (flag == "--url") options.url = value;
+            else if (flag == "--clients") options.clients = std::atoi(value.c_str());
+            else if (flag == "--players") options.players = std::atoi(value.c_str());
+            else if (flag == "--duration") options.duration = std::atof(value.c_str());
+            else if (flag == "--wire" && value == "json") options.wire = WireFormat::Json;
+            else if (flag == "--wire" && value == "msgpack") options.wire = WireFormat::MessagePack;
+            else if (flag == "--action-interval") options.action_interval = std::strtof(value.c_str(), nullptr);
+            else if (flag == "--subscribe") options.subscribe = value != "0";
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (flag == "--allow-remote") options.allow_remote = value != "0";
+            else if (flag == "--network") options.network = value;
+            else if (flag == "--record") options.record = value;
+            else {
+                std::cerr << "bad argument " << flag << " " << value << "\n";
+                return false;
+            }
+        }
+        return argc % 2 == 1 && options.clients > 0 && options.players > 0 && options.action_interval > 0;
+    }
+
+    WebSocketImpl::Ptr make_socket(const std::string &url) {
+        return std::make_shared<WebSocketDesktop>(url);
+    }
+
+    /**
+     * Null for no --network. Exits on a spec that is neither a preset nor a readable file.
+     */
+    std::shared_ptr<NetworkSimulator> create_network(const std::string &spec) {
+        if (spec.empty()) return nullptr;
+        for (const auto &preset: network_presets()) {
+            if (spec == preset.name) return std::make_shared<NetworkSimulator>(preset.conditions);
+        }
+        NetworkConditions conditions;
+        if (!load_network_conditions(spec, conditions)) {
+            std::cerr << "--network " << spec << " is neither a preset nor a readable conditions file\n";
+            std::exit(2);
+        }
+        conditions.enabled = true;
+        return std::make_shared<NetworkSimulator>(conditions);
+    }
+
+    /**
+     * Null for no --record. Exits if the file can't be written.
+     */
+    std::shared_ptr<SocketRecorder> create_recorder(const std::string &path) {
+        if (path.empty()) return nullptr;
+        auto recorder = SocketRecorder::Open(path);
+        if (recorder == nullptr) {
+            std::cerr << "can't write " << path << "\n";
+            std::exit(2);
+        }
+        return recorder;
+    }
+
+    /**
+     * Real sockets, behind network and recorded if there are those.
+     */
+    GameSession::SocketFactory socket_factory(const std::shared_ptr<NetworkSimulator> &network,
+                                              const std::shared_ptr<SocketRecorder> &recorder) {
+        GameSession::SocketFactory factory = make_socket;
+        if (network != nullptr) factory = network->Factory(std::move(factory));
+        if (recorder != nullptr) factory = recorder->Factory(std::move(factory));
+        return factory;
+    }
+
+    std::optional<int> player_index(const Client &client) {
+        const auto &ids = client.game->playerIds;
+        const auto it = std::ranges::find(ids, client.user->id);
+        if (it == ids.end()) return std::nullopt;
+        return static_cast<int>(it - ids.begin());
+    }
+
+    size_t words_spelling(const GameState &state, const int player, const std::string &text) {
+        if (player >= static_cast<int>(state.playerWords.size())) return 0;
+        return std::ranges::count_if(state.playerWords[player], [&](const Word &word) {
+            return !word.history.empty() && word.history.front() == text;
+        });
+    }
+
+    bool confirmed(const PendingAction &action, const MultiplayerGame &game, const int player) {
+        switch (action.kind) {
+            case ActionKind::Flip:
+                return std::ranges::none_of(game.state.tiles, [&](const TileProps &tile) {
+                    return tile.id == action.key && !tile.faceUp;
+                });
+            case ActionKind::Buzz:
+                return game.buzzHolder == player;
+            case ActionKind::Claim:
+                return words_spelling(game.state, player, action.key) > action.baseline;
+            case ActionKind::Chat:
+                return std::ranges::any_of(game.chat, [&](const MultiplayerChatMessage &message) {
+                    return message.message == action.key;
+                });
+        }
+        return false;
+    }
+
+    LatencyRecorder &recorder_for(Totals &totals, const ActionKind kind) {
+        switch (kind) {
+            case ActionKind::Flip: return totals.flip;
+            case ActionKind::Buzz: return totals.buzz;
+            case ActionKind::Claim: return totals.claim;
+            case ActionKind::Chat: break;
+        }
+        return totals.chat;
+    }
+
+    class LoadGenerator {
+    public:
+        explicit LoadGenerator(const Options &options)
+            : options_(options),
+              rng_(options.seed),
+              network_(create_network(options.network)),
+              recorder_(create_recorder(options.record)),
+              make_socket_(socket_factory(network_, recorder_)),
+              api_(options.url, make_socket_) {
+            clients_.resize(options.clients);
+            groups_.resize((options.clients + options.players - 1) / options.players);
+            for (int i = 0; i < options.clients; i++) {
+                auto &client = clients_[i];
+                client.index = i;
+                client.group = &groups_[i / options.players];
+                client.group->members.push_back(&client);
+                client.decoder = std::make_unique<GameMessageDecoder>(client.inbox);
+                const auto username = fmt::format("loadgen-{}-{}", options.seed, i);
+                request_user_login(api_, username, username, [this, &client](const ConnectionManager::Result &r) {
+                    OnLogin(client, r);
+                });
+            }
+        }
+
+        /**
+         * One pass over every client. acting: false once the run is winding down.
+         */
+        void Tick(const float delta_time, const bool acting) {
+            acting_ = acting;
+            api_.Poll();
+            for (auto &client: clients_) {
+                if (!client.user.has_value()) continue;
+                const auto &game_id = client.group->game_id;
+                if (!game_id.empty() && client.session_game != game_id) Join(client, game_id);
+                if (client.session != nullptr) Update(client, delta_time);
+            }
+        }
+
+        void PrintProgress(const double seconds) {
+            size_t connected = 0, logged_in = 0;
+            for (const auto &client: clients_) {
+                if (client.user.has_value()) logged_in++;
+                if (client.session != nullptr && client.session->CurrentStatus() == GameSession::Status::Open) {
+                    connected++;
+                }
+            }
+            fmt::print("{:6.1f} s | logged in {}, connected {} | games started {}, finished {} | "
+                       "received {:.0f}/s, sent {:.0f}/s\n",
+                       seconds, logged_in, connected, totals_.games_started, totals_.games_finished,
+                       static_cast<double>(totals_.received - last_received_) / (seconds - last_progress_),
+                       static_cast<double>(totals_.sent - last_sent_) / (seconds - last_progress_));
+            last_received_ = totals_.received;
+            last_sent_ = totals_.sent;
+            last_progress_ = seconds;
+        }
+
+        void PrintSummary(const double seconds) {
+            size_t drops = 0, reconnects = 0, decoded = 0, skipped = 0, failed_logins = 0, clock_samples = 0;
+            LatencyRecorder clock_bounds(clients_.size()), clock_errors(clients_.size());
+            const auto now = local_millis();
+            const auto true_offset = static_cast<double>(wall_millis() - now);
+            for (auto &client: clients_) {
+                failed_logins += client.login_failed;
+                clock_samples += client.clock.Samples();
+                if (client.clock.Synced()) {
+                    clock_bounds.Record(client.clock.ErrorBound(now));
+                    clock_errors.Record(std::abs(client.clock.Offset() - true_offset));
+                }
+                decoded += client.decoder->DecodedCount();
+                skipped += client.decoder->SkippedCount();
+                if (client.session == nullptr) continue;
+                drops += client.session->Drops();
+                reconnects += client.session->Reconnects();
+                totals_.unconfirmed += client.pending.size();
+            }
+            fmt::print("\n{} clients, {} per game, {} wire, {} for {:.1f} s\n", options_.clients, options_.players,
+                       options_.wire == WireFormat::MessagePack ? "MessagePack" : "JSON",
+                       options_.subscribe ? "push" : "polling", seconds);
+            fmt::print("received: {} messages, {:.1f}/s ({} decoded, {} skipped undecoded)\n", totals_.received,
+                       static_cast<double>(totals_.received) / seconds, decoded, skipped);
+            fmt::print("sent:     {} messages, {:.1f}/s\n", totals_.sent, static_cast<double>(totals_.sent) / seconds);
+            fmt::print("games:    {} started, {} finished\n", totals_.games_started, totals_.games_finished);
+            fmt::print("errors:   {} rejected, {} unconfirmed, {} undecodable, {} failed logins\n", totals_.rejected,
+                       totals_.unconfirmed, totals_.protocol_errors, failed_logins);
+            if (totals_.rejected > 0) fmt::print("          last rejection: {}\n", totals_.last_rejection);
+            fmt::print("sockets:  {} api connects, {} drops, {} reconnects\n", api_.Connects(), drops, reconnects);
+            fmt::print("clock:    {} samples; error bound p50 {:.1f} max {:.1f} ms; off this machine's clock by "
+                       "p50 {:.1f} max {:.1f} ms\n", clock_samples, clock_bounds.Percentile(50),
+                       clock_bounds.Percentile(100), clock_errors.Percentile(50), clock_errors.Percentile(100));
+            fmt::print("action round trips:\n");
+            print_latency("flip", totals_.flip);
+            print_latency("buzz", totals_.buzz);
+            print_latency("claim", totals_.claim);
+            print_latency("chat", totals_.chat);
+        }
+
+    private:
+        static void print_latency(const char *name, LatencyRecorder &recorder) {
+            fmt::print("{:<6} n={:<8} mean {:.3f}  p50 {:.3f}  p90 {:.3f}  p99 {:.3f}  p99.9 {:.3f}  max {:.3f} ms\n",
+                       name, recorder.Count(), recorder.Mean(), recorder.Percentile(50), recorder.Percentile(90),
+                       recorder.Percentile(99), recorder.Percentile(99.9), recorder.Percentile(100));
+        }
+
+        void OnLogin(Client &client, const ConnectionManager::Result &result) {
+            if (result.Ok()) {
+                try {
+                    if (auto response = deserialize<UserResponse>(result.message); response.ok) {
+                        client.user = std::move(response.user);
+                    }
+                } catch (const nlohmann::json::exception &) {
+                }
+            }
+            if (!client.user.has_value()) {
+                client.login_failed = true;
+                std::cerr << "client " << client.index << " couldn't log in: " << result.message << "\n";
+                return;
+            }
+            client.encoder.SetPlayer(client.user->id);
+            if (client.group->members.front() == &client) CreateGame(*client.group);
+        }
+
+        void CreateGame(Group &group) {
+            if (group.creating || !acting_) return;
+            group.creating = true;
+            auto &leader = *group.members.front();
+            request_new_game(api_, leader.user->token, [this, &group](const ConnectionManager::Result &result) {
+                group.creating = false;
+                if (!result.Ok()) {
+                    std::cerr << "create failed: " << result.message << "\n";
+                    return;
+                }
+                const auto response = deserialize<MultiplayerActionResponse>(result.message);
+                if (!response.ok || !response.game.has_value()) {
+                    std::cerr << "create failed: " << response.errorMessage << "\n";
+                    return;
+                }
+                group.game_id = response.game->id;
+                group.started = false;
+            });
+        }
+
+        void Join(Client &client, const std::string &game_id) {
+            client.session.reset();
+            client.decoder->Reset();
+            client.session = std::make_unique<GameSession>(
+                options_.url + "multiplayer/v2/" + game_id + wire_query(options_.wire), client.user->token,
+                client.decoder.get(), make_socket_);
+            client.session_game = game_id;
+            client.greeted = false;
+            client.game.reset();
+            client.hash.reset();
+            totals_.unconfirmed += client.pending.size();
+            client.pending.clear();
+            client.polls.Reset();
+            client.encoder.SetFormat(WireFormat::Json);
+        }
+
+        void Send(Client &client, const std::string &message, const GameSession::SendClass send_class,
+                  const bool queue_offline) {
+            if (queue_offline) client.session->SendOrQueue(message, client.encoder.Format(), send_class);
+            else if (!client.session->Send(message, client.encoder.Format(), send_class)) return;
+            totals_.sent++;
+        }
+
+        void SendPoll(Client &client) {
+            Send(client, client.encoder.Poll(client.hash, local_millis()), GameSession::SendClass::Poll, false);
+        }
+
+        void Update(Client &client, const float delta_time) {
+            auto &session = *client.session;
+            client.encoder.SetFormat(client.decoder->BinarySeen() ? WireFormat::MessagePack : WireFormat::Json);
+            session.Update(delta_time);
+            if (session.TakeReconnected()) {
+                client.greeted = false;
+                client.polls.Reset();
+            }
+            if (!client.greeted && session.CurrentStatus() == GameSession::Status::Open) {
+                if (options_.subscribe) {
+                    Send(client, client.encoder.Subscribe(), GameSession::SendClass::Control, false);
+                }
+                SendPoll(client);
+                client.greeted = true;
+            }
+            client.polls.SetLobby(!client.game.has_value() || client.game->phase == "CREATED");
+            client.polls.SetBuzzing(client.game.has_value() && client.game->buzzHolder.has_value());
+            if (client.polls.Tick(delta_time)) SendPoll(client);
+
+            GameMessage message;
+            while (client.inbox.try_dequeue(message)) {
+                totals_.received++;
+                Receive(client, message);
+            }
+
+            const auto now = Clock::now();
+            std::erase_if(client.pending, [&](const PendingAction &action) {
+                if (now - action.sent < UNCONFIRMED_AFTER) return false;
+                totals_.unconfirmed++;
+                return true;
+            });
+            if (acting_ && client.game.has_value() && client.game->phase == "ONGOING") {
+                client.until_action -= delta_time;
+                if (client.until_action <= 0) {
+                    std::uniform_real_distribution<float> jitter(0.5f, 1.5f);
+                    client.until_action = options_.action_interval * jitter(rng_);
+                    Act(client);
+                }
+            }
+            session.Flush();
+        }
+
+        void Receive(Client &client, GameMessage &message) {
+            if (const auto *timing = reply_timing(message)) client.clock.AddReply(*timing);
+            if (std::holds_alternative<ProtocolError>(message)) {
+                totals_.protocol_errors++;
+                client.polls.OnResponse(false, false);
+                return;
+            }
+            if (const auto *skipped = std::get_if<SkippedResponse>(&message)) {
+                client.polls.OnResponse(skipped->pushed, false);
+                return;
+            }
+            if (const auto *delta = std::get_if<GameDeltaResponse>(&message)) {
+                client.polls.OnResponse(delta->pushed, delta->ok && delta->hashCode != client.hash);
+                if (!delta->ok) {
+                    totals_.rejected++;
+                    totals_.last_rejection = delta->errorMessage;
+                    return;
+                }
+                if (!client.game.has_value() || delta->delta.baseHash != client.hash) {
+                    client.polls.PollNow(); // Same as the game client: don't wait out a push keepalive
+                    return;
+                }
+                const bool was_finished = client.game->phase == "FINISHED";
+                if (!apply_game_delta(*client.game, delta->delta)) {
+                    client.hash.reset(); // Next POLL asks for a snapshot
+                    client.polls.PollNow();
+                    return;
+                }
+                Applied(client, delta->hashCode, was_finished);
+                return;
+            }
+            auto &response = std::get<MultiplayerActionResponse>(message);
+            client.polls.OnResponse(response.pushed, response.ok && response.hashCode != client.hash);
+            if (!response.ok) {
+                totals_.rejected++;
+                totals_.last_rejection = response.errorMessage;
+                return;
+            }
+            if (response.game.has_value() && response.game->id == client.session_game) {
+                Apply(client, std::move(*response.game), response.hashCode);
+            }
+        }
+
+        void Apply(Client &client, MultiplayerGame game, const int hash_code) {
+            const bool was_finished = client.game.has_value() && client.game->phase == "FINISHED";
+            client.game = std::move(game);
+            Applied(client, hash_code, was_finished);
+        }
+
+        /**
+         * client.game is now at hash_code, by a snapshot or a delta applied in place.
+         */
+        void Applied(Client &client, const int hash_code, const bool was_finished) {
+            client.hash = hash_code;
+            const auto player = player_index(client);
+            if (player.has_value()) {
+                const auto now = Clock::now();
+                std::erase_if(client.pending, [&](const PendingAction &action) {
+                    if (!confirmed(action, *client.game, *player)) return false;
+                    recorder_for(totals_, action.kind).Record(now - action.sent);
+                    return true;
+                });
+            }
+
+            auto &group = *client.group;
+            if (group.members.front() != &client) return;
+            const auto &phase = client.game->phase;
+            if (phase == "CREATED" && !group.started &&
+                client.game->playerIds.size() == group.members.size()) {
+                Send(client, client.encoder.Start(), GameSession::SendClass::Control, true);
+                group.started = true;
+                totals_.games_started++;
+            } else if (phase == "FINISHED" && !was_finished) {
+                totals_.games_finished++;
+                CreateGame(group);
+            }
+        }
+
+        void Act(Client &client) {
+            const auto &game = *client.game;
+            const auto player = player_index(client);
+            if (!player.has_value()) return;
+            std::vector<const TileProps *> face_up, face_down;
+            for (const auto &tile: game.state.tiles) (tile.faceUp ? face_up : face_down).push_back(&tile);
+            const auto minimum = static_cast<size_t>(game.state.wordMinimumSize);
+            const auto now = Clock::now();
+            std::uniform_real_distribution<double> chance(0, 1);
+
+            if (chance(rng_) < CHAT_CHANCE) {
+                auto text = fmt::format("{}:{}", client.index, client.chats++);
+                Send(client, client.encoder.Chat(text), GameSession::SendClass::Chat, true);
+                client.pending.push_back({ActionKind::Chat, std::move(text), 0, now});
+                return;
+            }
+            if (game.buzzHolder == *player && face_up.size() >= minimum) {
+                std::ranges::shuffle(face_up, rng_);
+                std::string word;
+                for (size_t i = 0; i < minimum; i++) word += face_up[i]->letter;
+                const auto baseline = words_spelling(game.state, *player, word);
+                Send(client, client.encoder.Claim(*player, std::nullopt, "", word), GameSession::SendClass::Claim,
+                     true);
+                client.pending.push_back({ActionKind::Claim, std::move(word), baseline, now});
+                return;
+            }
+            const bool buzz_pending = std::ranges::any_of(client.pending, [](const PendingAction &action) {
+                return action.kind == ActionKind::Buzz || action.kind == ActionKind::Claim;
+            });
+            if (!game.buzzHolder.has_value() && !buzz_pending && face_up.size() >= minimum &&
+                (face_down.empty() || chance(rng_) < BUZZ_CHANCE)) {
+                Send(client, client.encoder.Buzz(), GameSession::SendClass::Claim, true);
+                client.pending.push_back({ActionKind::Buzz, "", 0, now});
+                return;
+            }
+            if (!face_down.empty()) {
+                std::uniform_int_distribution<size_t> pick(0, face_down.size() - 1);
+                const auto &tile_id = face_down[pick(rng_)]->id;
+                Send(client, client.encoder.Flip(*player, tile_id), GameSession::SendClass::Flip, true);
+                client.pending.push_back({ActionKind::Flip, tile_id, 0, now});
+                return;
+            }
+            if (face_up.size() < minimum && client.group->members.front() == &client) {
+                Send(client, client.encoder.End(), GameSession::SendClass::Control, true); // Nothing left to play
+            }
+        }
+
+        const Options &options_;
+
+        std::mt19937 rng_;
+
+        std::shared_ptr<NetworkSimulator> network_;
+
+        std::shared_ptr<SocketRecorder> recorder_;
+
+        GameSession::SocketFactory make_socket_;
+
+        ConnectionManager api_;
+
+        std::vector<Group> groups_; // Before clients_, which point into it
+
+        std::vector<Client> clients_;
+
+        Totals totals_;
+
+        bool acting_{true};
+
+        size_t last_received_{0};
+
+        size_t last_sent_{0};
+
+        double last_progress_{0};
+    };
+}
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (const char *env_url = std::getenv("PIRATE_SCRABBLE_API"); env_url != nullptr && *env_url != '\0') {
+        options.url = env_url;
+    } else {
+        options.url = "ws://127.0.0.1:8080/ws/";
+    }
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: pirate-scrabble-loadgen [--url ws://host:port/ws/] [--clients N] [--players N]"
+                " [--duration seconds] [--wire json|msgpack] [--action-interval seconds] [--subscribe 0|1]"
+                " [--seed N] [--allow-remote 0|1] [--network preset|path] [--record path]\n";
+        return 2;
+    }
+    if (options.url.find("playpiratescrabble.com") != std::string::npos && !options.allow_remote) {
+        std::cerr << options.url << " is the production server; use pirate-scrabble-server,"
+                " or --allow-remote 1 if you really mean it\n";
+        return 2;
+    }
+    if (!options.url.ends_with('/')) options.url += '/';
+
+    Logger::Initialize("pirate-scrabble-loadgen.log");
+    ix::initNetSystem();
+    fmt::print("{} clients against {}\n", options.clients, options.url);
+    {
+        LoadGenerator generator(options);
+        const auto start = Clock::now();
+        auto last = start;
+        double next_progress = 5;
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const auto now = Clock::now();
+            const double elapsed = std::chrono::duration<double>(now - start).count();
+            generator.Tick(std::chrono::duration<float>(now - last).count(), elapsed < options.duration);
+            last = now;
+            if (elapsed >= next_progress) {
+                generator.PrintProgress(elapsed);
+                next_progress += 5;
+            }
+            // A second after the last action, to let its round trip finish
+            if (elapsed >= options.duration + 1) {
+                generator.PrintSummary(options.duration);
+                break;
+            }
+        }
+    }
+    ix::uninitNetSystem();
+    return 0;
+}
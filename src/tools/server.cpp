@@ -0,0 +1,197 @@
+// pirate-scrabble-server: a local stand-in for the API server, for development and load tests.
+//
+//   pirate-scrabble-server [--port N] [--host addr] [--words <list.txt|dict.dawg>] [--min-length N]
+//                          [--seed N] [--stats-interval seconds]
+//
+// Serves account/login, account/tokenAuth, multiplayer/create and multiplayer/v2/<id> under /ws/,
+// plain ws:// only; see StandInServer for what each endpoint does. Point the game or
+// pirate-scrabble-loadgen at it with PIRATE_SCRABBLE_API=ws://127.0.0.1:8080/ws/. Unknown
+// usernames are registered on first login, with whatever password they came with.
+//
+// Without --words any claim that can be made from the tiles is accepted. Counters are printed
+// every --stats-interval seconds (0 for never) and on exit (Ctrl-C).
+
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "fmt/core.h"
+#include "ixwebsocket/IXNetSystem.h"
+#include "ixwebsocket/IXWebSocketServer.h"
+
+#include "tools/common/stand_in_server.h"
+#include "tools/common/synthetic_game.h"
+
+using namespace scrabble;
+
+namespace {
+    struct Options {
+        int port = 8080;
+        std::string host = "127.0.0.1";
+        std::string words_path;
+        int min_length = 3;
+        unsigned seed = 1;
+        int stats_interval = 10;
+    };
+
+    std::atomic<bool> interrupted{false};
+
+    bool parse_options(const int argc, char **argv, Options &options) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string flag = argv[i];
+            const std::string value = argv[i + 1];
+            if (flag == "--port") options.port = std::atoi(value.c_str());
+            else if (flag == "--host") options.host = value;
+            else if (flag == "--words") options.words_path = value;
+            else if (flag == "--min-length") options.min_length = std::atoi(value.c_str());
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (flag == "--stats-interval") options.stats_interval = std::atoi(value.c_str());
+            else {
+                std::cerr << "bad argument " << flag << " " << value << "\n";
+                return false;
+            }
+        }
+        return argc % 2 == 1 && options.port > 0 && options.min_length > 0;
+    }
+
+    /**
+     * Live sockets by connection id, so replies and pushes can reach any client.
+     */
+    class Transport {
+    public:
+        void Add(const tools::StandInServer::ConnectionId id, std::weak_ptr<ix::WebSocket> socket) {
+            std::lock_guard lock(mutex_);
+            sockets_[id] = std::move(socket);
+        }
+
+        void Remove(const tools::StandInServer::ConnectionId id) {
+            std::lock_guard lock(mutex_);
+            sockets_.erase(id);
+        }
+
+        void Send(const std::vector<tools::Outgoing> &frames) {
+            for (const auto &frame: frames) {
+                std::shared_ptr<ix::WebSocket> socket;
+                {
+                    std::lock_guard lock(mutex_);
+                    if (const auto it = sockets_.find(frame.connection); it != sockets_.end()) {
+                        socket = it->second.lock();
+                    }
+                }
+                if (socket == nullptr) continue; // Closed since
+                if (frame.binary) socket->sendBinary(frame.payload);
+                else socket->sendText(frame.payload);
+                sent_.fetch_add(1, std::memory_order_relaxed);
+                sent_bytes_.fetch_add(frame.payload.size(), std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] size_t Sent() const { return sent_.load(std::memory_order_relaxed); }
+
+        [[nodiscard]] size_t SentBytes() const { return sent_bytes_.load(std::memory_order_relaxed); }
+
+    private:
+        std::mutex mutex_;
+
+        std::unordered_map<tools::StandInServer::ConnectionId, std::weak_ptr<ix::WebSocket> > sockets_;
+
+        std::atomic<size_t> sent_{0};
+
+        std::atomic<size_t> sent_bytes_{0};
+    };
+
+    void print_stats(tools::StandInServer &server, const Transport &transport, const size_t received) {
+        const auto stats = server.GetStats();
+        fmt::print("connections {}, users {}, games {} | received {}, actions {} ({} rejected) | "
+                   "sent {} ({:.1f} MB): {} snapshots, {} deltas, {} pushes\n",
+                   stats.connections, stats.users, stats.games, received, stats.actions, stats.rejected,
+                   transport.Sent(), static_cast<double>(transport.SentBytes()) / 1e6, stats.snapshots,
+                   stats.deltas, stats.pushes);
+    }
+}
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: pirate-scrabble-server [--port N] [--host addr] [--words path] [--min-length N]"
+                " [--seed N] [--stats-interval seconds]\n";
+        return 2;
+    }
+
+    std::unordered_set<std::string> words;
+    if (!options.words_path.empty()) {
+        std::vector<std::string> list;
+        if (!tools::load_word_list(options.words_path, list)) return 1;
+        words.insert(list.begin(), list.end());
+        fmt::print("{} words from {}\n", words.size(), options.words_path);
+    }
+
+    tools::StandInSettings settings;
+    settings.word_minimum_size = options.min_length;
+    tools::StandInServer server(options.seed, settings, std::move(words));
+    Transport transport;
+    std::atomic<tools::StandInServer::ConnectionId> next_id{1};
+    std::atomic<size_t> received{0};
+    std::mutex ordering;
+
+    ix::initNetSystem();
+    // One thread per connection; load tests open a few hundred at once
+    ix::WebSocketServer ws_server(options.port, options.host, ix::SocketServer::kDefaultTcpBacklog, 4096);
+    ws_server.disablePerMessageDeflate(); // Frames are small; deflate only costs CPU on loopback
+    ws_server.setOnConnectionCallback([&](const std::weak_ptr<ix::WebSocket> &weak_socket,
+                                          const std::shared_ptr<ix::ConnectionState> &) {
+        const auto socket = weak_socket.lock();
+        if (socket == nullptr) return;
+        const auto id = next_id.fetch_add(1, std::memory_order_relaxed);
+        transport.Add(id, weak_socket);
+        socket->setOnMessageCallback([&, id, raw = socket.get()](const ix::WebSocketMessagePtr &msg) {
+            std::vector<tools::Outgoing> out;
+            // Each connection has its own thread. Frames must leave in the order the state changed,
+            // or a push could overtake the one it's a delta against.
+            std::lock_guard lock(ordering);
+            switch (msg->type) {
+                case ix::WebSocketMessageType::Open:
+                    if (!server.Open(id, tools::api_path(msg->openInfo.uri))) {
+                        raw->close(4004, "no such endpoint");
+                    }
+                    break;
+                case ix::WebSocketMessageType::Message:
+                    received.fetch_add(1, std::memory_order_relaxed);
+                    server.Receive(id, msg->str, msg->binary, out);
+                    break;
+                case ix::WebSocketMessageType::Close:
+                    server.Close(id);
+                    transport.Remove(id);
+                    break;
+                default:
+                    break;
+            }
+            transport.Send(out);
+        });
+    });
+
+    const auto [listening, error] = ws_server.listen();
+    if (!listening) {
+        std::cerr << "can't listen on " << options.host << ":" << options.port << ": " << error << "\n";
+        return 1;
+    }
+    ws_server.start();
+    fmt::print("listening on ws://{}:{}/ws/\n", options.host, options.port);
+
+    std::signal(SIGINT, [](int) { interrupted = true; });
+    std::signal(SIGTERM, [](int) { interrupted = true; });
+    int seconds = 0;
+    while (!interrupted) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (options.stats_interval > 0 && ++seconds % options.stats_interval == 0) {
+            print_stats(server, transport, received);
+        }
+    }
+    ws_server.stop();
+    print_stats(server, transport, received);
+    ix::uninitNetSystem();
+    return 0;
+}
@@ -0,0 +1,231 @@
+// pirate-scrabble-sim: plays whole games locally, no window or server, to time the rules code.
+//
+//   pirate-scrabble-sim [--words <list.txt|dict.dawg>] [--games N] [--players N] [--min-length N]
+//                       [--policy scripted|solver] [--attempts N] [--sample N] [--seed N]
+//
+// scripted players each try --attempts random dictionary words per turn against the pool and
+// every claimed word with can_steal_word, and claim the first one that works. solver players
+// run solve_claims and take the best claim. Either way, when nobody claims, the next tile flips;
+// the game ends once every tile is face up and nobody can claim.
+//
+// Every game is checked at the end: all 144 tiles must still be on the table or in a word.
+// --sample N records latency for one operation in N, to bound memory on long soak runs.
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "fmt/core.h"
+
+#include "scrabble/actions/anagram_index.h"
+#include "scrabble/actions/apply_actions.h"
+#include "scrabble/actions/legal_actions.h"
+#include "scrabble/actions/solver.h"
+#include "scrabble/actions/tile_bag.h"
+#include "scrabble/context/types.h"
+#include "tools/common/synthetic_game.h"
+#include "util/stats/latency_recorder.h"
+
+using namespace scrabble;
+
+namespace {
+    enum class Policy {
+        Scripted, Solver
+    };
+
+    struct Options {
+        std::string words_path;
+        long games = 1000;
+        int players = 4;
+        int min_length = 3;
+        Policy policy = Policy::Scripted;
+        int attempts = 64;
+        int sample = 1;
+        unsigned seed = 1;
+    };
+
+    struct Stats {
+        LatencyRecorder flip;
+        LatencyRecorder claim;
+        LatencyRecorder turn; // One player's whole decision: attempts or a full solve
+        long flips = 0;
+        long claims = 0;
+        long steals = 0;
+        long operations = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    bool parse_options(const int argc, char **argv, Options &options) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string flag = argv[i];
+            const std::string value = argv[i + 1];
+            if (flag == "--words") options.words_path = value;
+            else if (flag == "--games") options.games = std::atol(value.c_str());
+            else if (flag == "--players") options.players = std::atoi(value.c_str());
+            else if (flag == "--min-length") options.min_length = std::atoi(value.c_str());
+            else if (flag == "--attempts") options.attempts = std::atoi(value.c_str());
+            else if (flag == "--sample") options.sample = std::max(1, std::atoi(value.c_str()));
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (flag == "--policy" && value == "scripted") options.policy = Policy::Scripted;
+            else if (flag == "--policy" && value == "solver") options.policy = Policy::Solver;
+            else {
+                std::cerr << "bad argument " << flag << " " << value << "\n";
+                return false;
+            }
+        }
+        return options.players > 0;
+    }
+
+    /**
+     * First of `attempts` random words that is legal, as a claim for player.
+     */
+    std::optional<GameStateUpdate> scripted_turn(std::mt19937 &rng, const std::vector<std::string> &words,
+                                                 const GameState &game, const int player, const int attempts) {
+        std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+        const auto pool = public_histogram(game);
+        for (int attempt = 0; attempt < attempts; attempt++) {
+            const auto &word = words[pick(rng)];
+            if (static_cast<int>(word.size()) < game.wordMinimumSize) continue;
+            const auto letters = LetterHistogram::FromWord(word);
+            for (int owner = 0; owner < static_cast<int>(game.playerWords.size()); owner++) {
+                for (const auto &stolen: game.playerWords[owner]) {
+                    if (can_steal_word(word, letters, stolen, pool)) {
+                        return GameStateUpdate{"CLAIM", "", word, stolen.id, player, owner};
+                    }
+                }
+            }
+            if (letters.IsSubsetOf(pool)) {
+                return GameStateUpdate{"CLAIM", "", word, "", player, std::nullopt};
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<GameStateUpdate> solver_turn(const AnagramIndex &index, const GameState &game, const int player,
+                                               std::vector<Claim> &claims) {
+        claims.clear();
+        solve_claims(game, index, claims);
+        if (claims.empty()) return std::nullopt;
+        const auto &best = claims.front();
+        if (best.stolen) {
+            return GameStateUpdate{"CLAIM", "", std::string(best.word), best.stolen->id, player, best.player};
+        }
+        return GameStateUpdate{"CLAIM", "", std::string(best.word), "", player, std::nullopt};
+    }
+
+    int tiles_accounted_for(const GameState &game) {
+        size_t total = game.tiles.size();
+        for (const auto &player_words: game.playerWords) {
+            for (const auto &word: player_words) total += word.history.front().size();
+        }
+        return static_cast<int>(total);
+    }
+
+    template<typename F>
+    auto timed(Stats &stats, LatencyRecorder &recorder, const int sample, F &&f) {
+        const bool record = stats.operations++ % sample == 0;
+        const auto start = record ? Clock::now() : Clock::time_point{};
+        auto result = f();
+        if (record) recorder.Record(Clock::now() - start);
+        return result;
+    }
+
+    bool play_game(std::mt19937 &rng, const Options &options, const std::vector<std::string> &words,
+                   const AnagramIndex *index, Stats &stats) {
+        auto game = new_game_state(rng, options.players, options.min_length, "SIM");
+        std::vector<Claim> claims;
+        int word_id = 0;
+        int next_player = 0;
+        while (true) {
+            // Everyone gets a look at the board, starting after whoever claimed last
+            std::optional<GameStateUpdate> claim;
+            for (int offset = 0; offset < options.players && !claim; offset++) {
+                const int player = (next_player + offset) % options.players;
+                claim = timed(stats, stats.turn, options.sample, [&] {
+                    return options.policy == Policy::Solver
+                               ? solver_turn(*index, game, player, claims)
+                               : scripted_turn(rng, words, game, player, options.attempts);
+                });
+            }
+            if (claim) {
+                const auto id = "w" + std::to_string(word_id++);
+                const bool applied = timed(stats, stats.claim, options.sample, [&] {
+                    return apply_claim(game, *claim, id);
+                });
+                if (!applied) {
+                    std::cerr << "legal claim rejected: " << claim->claimWord << "\n";
+                    return false;
+                }
+                stats.claims++;
+                if (!claim->stolenWordId.empty()) stats.steals++;
+                next_player = (claim->actingPlayer + 1) % options.players;
+                continue;
+            }
+            const int tile = next_face_down(game);
+            if (tile < 0) break;
+            const auto &id = game.tiles[static_cast<size_t>(tile)].id;
+            timed(stats, stats.flip, options.sample, [&] { return apply_flip(game, id); });
+            stats.flips++;
+        }
+        if (tiles_accounted_for(game) != TILE_TOTAL) {
+            std::cerr << "tiles lost: " << tiles_accounted_for(game) << " of " << TILE_TOTAL << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    void print_latency(const char *name, LatencyRecorder &recorder) {
+        fmt::print("{:<6} n={:<10} mean {:.4f}  p50 {:.4f}  p90 {:.4f}  p99 {:.4f}  p99.9 {:.4f}  max {:.4f} ms\n",
+                   name, recorder.Count(), recorder.Mean(), recorder.Percentile(50), recorder.Percentile(90),
+                   recorder.Percentile(99), recorder.Percentile(99.9), recorder.Percentile(100));
+    }
+}
+
+int main(const int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: pirate-scrabble-sim [--words path] [--games N] [--players N] [--min-length N]"
+                " [--policy scripted|solver] [--attempts N] [--sample N] [--seed N]\n";
+        return 2;
+    }
+
+    std::mt19937 rng(options.seed);
+    std::vector<std::string> words;
+    if (options.words_path.empty()) {
+        words = tools::synthetic_word_list(rng, 50000);
+    } else if (!tools::load_word_list(options.words_path, words)) {
+        return 1;
+    }
+    if (words.empty()) {
+        std::cerr << "empty word list\n";
+        return 1;
+    }
+
+    std::unique_ptr<AnagramIndex> index;
+    if (options.policy == Policy::Solver) {
+        index = std::make_unique<AnagramIndex>();
+        index->Build(words);
+    }
+
+    Stats stats;
+    const auto start = Clock::now();
+    for (long g = 0; g < options.games; g++) {
+        if (!play_game(rng, options, words, index.get(), stats)) {
+            std::cerr << "game " << g << " failed (seed " << options.seed << ")\n";
+            return 1;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    fmt::print("games:  {} in {:.2f} s, {:.1f} games/s\n", options.games, seconds,
+               static_cast<double>(options.games) / seconds);
+    fmt::print("claims: {} ({} steals), {:.1f} claims/s, {:.1f} per game\n", stats.claims, stats.steals,
+               static_cast<double>(stats.claims) / seconds,
+               static_cast<double>(stats.claims) / static_cast<double>(std::max(options.games, 1L)));
+    fmt::print("flips:  {}\n", stats.flips);
+    print_latency("turn", stats.turn);
+    print_latency("claim", stats.claim);
+    print_latency("flip", stats.flip);
+    return 0;
+}
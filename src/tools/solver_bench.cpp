@@ -0,0 +1,115 @@
+// solver-bench: times the claim solver on synthetic boards.
+//
+//   solver-bench [--words <list.txt|dict.dawg>] [--boards N] [--players N] [--claimed N] [--face-up N] [--seed N]
+//                [--threads N]
+//
+// Without --words, a synthetic 250k word list is used. --face-up -1 (the default) flips every
+// tile that isn't in a word, which is the worst case for the search. Each board is solved on
+// the calling thread, then again through ClaimSearch on a pool of --threads workers
+// (default: WorkStealingPool::DefaultThreadCount(), 0 to skip).
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "fmt/core.h"
+
+#include "scrabble/actions/anagram_index.h"
+#include "scrabble/actions/claim_search.h"
+#include "scrabble/actions/solver.h"
+#include "tools/common/synthetic_game.h"
+#include "util/stats/latency_recorder.h"
+#include "util/thread_pool/work_stealing_pool.h"
+
+using namespace scrabble;
+
+int main(const int argc, char **argv) {
+    std::string words_path;
+    int boards = 200;
+    int players = 4;
+    int claimed = 24;
+    int face_up = -1;
+    unsigned seed = 1;
+    int threads = static_cast<int>(WorkStealingPool::DefaultThreadCount());
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const char *value = argv[i + 1];
+        if (flag == "--words") words_path = value;
+        else if (flag == "--boards") boards = std::atoi(value);
+        else if (flag == "--players") players = std::atoi(value);
+        else if (flag == "--claimed") claimed = std::atoi(value);
+        else if (flag == "--face-up") face_up = std::atoi(value);
+        else if (flag == "--seed") seed = static_cast<unsigned>(std::atoi(value));
+        else if (flag == "--threads") threads = std::atoi(value);
+        else {
+            std::cerr << "unknown flag " << flag << "\n";
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<std::string> words;
+    if (words_path.empty()) {
+        words = tools::synthetic_word_list(rng, 250000);
+    } else if (!tools::load_word_list(words_path, words)) {
+        return 1;
+    }
+
+    const auto index_start = std::chrono::steady_clock::now();
+    auto index_owner = std::make_shared<AnagramIndex>();
+    auto &index = *index_owner;
+    index.Build(words);
+    const auto index_time = std::chrono::steady_clock::now() - index_start;
+
+    std::unique_ptr<WorkStealingPool> pool;
+    std::unique_ptr<ClaimSearch> search;
+    if (threads > 0) {
+        pool = std::make_unique<WorkStealingPool>(static_cast<size_t>(threads));
+        search = std::make_unique<ClaimSearch>(*pool);
+    }
+
+    LatencyRecorder solve_times(static_cast<size_t>(boards));
+    LatencyRecorder parallel_times(static_cast<size_t>(boards));
+    size_t mismatches = 0;
+    ClaimSearchResult result;
+    std::vector<Claim> claims;
+    claims.reserve(4096);
+    size_t total_claims = 0;
+    size_t total_targets = 0;
+    for (int b = 0; b < boards; b++) {
+        const auto game = tools::synthetic_board(rng, words, players, claimed, face_up);
+        claims.clear();
+        const auto start = std::chrono::steady_clock::now();
+        solve_claims(game, index, claims);
+        solve_times.Record(std::chrono::steady_clock::now() - start);
+        total_claims += claims.size();
+
+        if (search) {
+            const auto parallel_start = std::chrono::steady_clock::now();
+            search->Start(game, index_owner, std::chrono::seconds(10));
+            while (!search->TakeResult(result)) {
+                std::this_thread::yield();
+            }
+            parallel_times.Record(std::chrono::steady_clock::now() - parallel_start);
+            if (!result.complete || result.claims.size() != claims.size()) mismatches++;
+        }
+        for (const auto &player_words: game.playerWords) total_targets += player_words.size();
+        total_targets += 1;
+    }
+
+    fmt::print("words:        {} ({} anagram classes)\n", index.WordCount(), index.Classes().size());
+    fmt::print("index build:  {:.1f} ms\n", std::chrono::duration<double, std::milli>(index_time).count());
+    fmt::print("boards:       {} ({:.1f} targets, {:.1f} claims per board)\n", boards,
+               static_cast<double>(total_targets) / boards, static_cast<double>(total_claims) / boards);
+    fmt::print("solve ms:     mean {:.3f}  p50 {:.3f}  p90 {:.3f}  p99 {:.3f}  max {:.3f}\n",
+               solve_times.Mean(), solve_times.Percentile(50), solve_times.Percentile(90),
+               solve_times.Percentile(99), solve_times.Percentile(100));
+    if (search) {
+        fmt::print("{} threads:    mean {:.3f}  p50 {:.3f}  p90 {:.3f}  p99 {:.3f}  max {:.3f}  ({} mismatched)\n",
+                   threads, parallel_times.Mean(), parallel_times.Percentile(50), parallel_times.Percentile(90),
+                   parallel_times.Percentile(99), parallel_times.Percentile(100), mismatches);
+    }
+    return 0;
+}
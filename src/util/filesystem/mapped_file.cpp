@@ -0,0 +1,126 @@
+#include "mapped_file.h"
+
+#include <iostream>
+#include <fstream>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this == &other) return *this;
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mapped_ = std::exchange(other.mapped_, false);
+    fallback_ = std::move(other.fallback_);
+#ifdef _WIN32
+    file_handle_ = std::exchange(other.file_handle_, nullptr);
+    mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string &path) {
+    Close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open file for mapping: " << path << "\n";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        std::cerr << "Cannot map empty file: " << path << "\n";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "Failed to map file: " << path << "\n";
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const unsigned char *>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    mapped_ = true;
+    return true;
+#elif !defined(__EMSCRIPTEN__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file for mapping: " << path << "\n";
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        std::cerr << "Cannot map empty file: " << path << "\n";
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << path << "\n";
+        return false;
+    }
+    data_ = static_cast<const unsigned char *>(view);
+    size_ = static_cast<size_t>(st.st_size);
+    mapped_ = true;
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file for reading: " << path << "\n";
+        return false;
+    }
+    fallback_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (fallback_.empty() || !file.read(reinterpret_cast<char *>(fallback_.data()),
+                                         static_cast<std::streamsize>(fallback_.size()))) {
+        std::cerr << "I/O error while reading file: " << path << "\n";
+        fallback_.clear();
+        return false;
+    }
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+#endif
+}
+
+void MappedFile::Close() {
+    if (data_ == nullptr) return;
+#if defined(_WIN32)
+    if (mapped_) {
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        mapping_handle_ = nullptr;
+        file_handle_ = nullptr;
+    }
+#elif !defined(__EMSCRIPTEN__)
+    if (mapped_) munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+    fallback_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only view of a whole file. Memory-mapped where the platform allows it, otherwise
+ * (Emscripten) read into a single buffer. Either way it is one allocation at most,
+ * and the contents are never copied again.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept;
+
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    ~MappedFile();
+
+    bool Open(const std::string &path);
+
+    void Close();
+
+    [[nodiscard]] const unsigned char *Data() const { return data_; }
+
+    [[nodiscard]] size_t Size() const { return size_; }
+
+    [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+
+private:
+    const unsigned char *data_{nullptr};
+
+    size_t size_{0};
+
+    bool mapped_{false};
+
+    std::vector<unsigned char> fallback_;
+
+#ifdef _WIN32
+    void *file_handle_{nullptr};
+    void *mapping_handle_{nullptr};
+#endif
+};
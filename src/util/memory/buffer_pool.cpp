@@ -0,0 +1,52 @@
+#include "buffer_pool.h"
+
+PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept {
+    if (this != &other) {
+        Release();
+        pool_ = other.pool_;
+        data_ = std::move(other.data_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+void PooledBuffer::Release() {
+    if (pool_ == nullptr) return;
+    pool_->Return(std::move(data_));
+    pool_ = nullptr;
+    data_ = std::string{};
+}
+
+BufferPool::BufferPool(const size_t max_pooled, const size_t initial_capacity)
+    : idle_buffers_(max_pooled), max_pooled_(max_pooled), initial_capacity_(initial_capacity) {
+}
+
+PooledBuffer BufferPool::Acquire() {
+    std::string buffer;
+    if (idle_buffers_.try_dequeue(buffer)) {
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+        reused_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        buffer.reserve(initial_capacity_);
+        allocated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return PooledBuffer(this, std::move(buffer));
+}
+
+PooledBuffer BufferPool::Copy(const std::string_view data) {
+    auto buffer = Acquire();
+    buffer.Data().assign(data);
+    return buffer;
+}
+
+void BufferPool::Return(std::string &&buffer) {
+    // Over the limit (a burst) the extra buffers are simply freed
+    if (idle_.fetch_add(1, std::memory_order_relaxed) >= max_pooled_) {
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.clear();
+    if (!idle_buffers_.enqueue(std::move(buffer))) {
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "concurrentqueue.h"
+
+class BufferPool;
+
+/**
+ * A string borrowed from a BufferPool. Move it between threads like the string itself; when the
+ * last owner lets go it goes back to the pool with its capacity, ready for the next message.
+ */
+class PooledBuffer {
+public:
+    PooledBuffer() = default;
+
+    PooledBuffer(PooledBuffer &&other) noexcept : pool_(other.pool_), data_(std::move(other.data_)) {
+        other.pool_ = nullptr;
+    }
+
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+
+    PooledBuffer(const PooledBuffer &) = delete;
+
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+    ~PooledBuffer() { Release(); }
+
+    [[nodiscard]] std::string &Data() { return data_; }
+
+    [[nodiscard]] const std::string &Data() const { return data_; }
+
+    [[nodiscard]] std::string_view View() const { return data_; }
+
+    /**
+     * Hands the string back now instead of at destruction; the buffer is empty afterwards.
+     */
+    void Release();
+
+private:
+    friend class BufferPool;
+
+    PooledBuffer(BufferPool *pool, std::string data) : pool_(pool), data_(std::move(data)) {
+    }
+
+    BufferPool *pool_{nullptr};
+
+    std::string data_;
+};
+
+/**
+ * Recycles strings between a producer thread (a socket callback) and consumers, so that once
+ * enough buffers of the right size exist, receiving a message costs a memcpy and no allocation.
+ * Lock-free; must outlive every PooledBuffer it hands out.
+ */
+class BufferPool {
+public:
+    /**
+     * At most max_pooled idle buffers are kept; more are freed on release. New buffers start
+     * with initial_capacity reserved.
+     */
+    explicit BufferPool(size_t max_pooled = 64, size_t initial_capacity = 16 * 1024);
+
+    /**
+     * An empty buffer, recycled if one is idle.
+     */
+    PooledBuffer Acquire();
+
+    /**
+     * Acquire() holding a copy of data.
+     */
+    PooledBuffer Copy(std::string_view data);
+
+    /**
+     * Buffers created because none was idle. Flat in steady state.
+     */
+    [[nodiscard]] size_t Allocated() const { return allocated_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t Reused() const { return reused_.load(std::memory_order_relaxed); }
+
+    /**
+     * Idle buffers right now (approximate under concurrency).
+     */
+    [[nodiscard]] size_t Idle() const { return idle_.load(std::memory_order_relaxed); }
+
+private:
+    friend class PooledBuffer;
+
+    void Return(std::string &&buffer);
+
+    moodycamel::ConcurrentQueue<std::string> idle_buffers_;
+
+    size_t max_pooled_;
+
+    size_t initial_capacity_;
+
+    std::atomic<size_t> idle_{0};
+
+    std::atomic<size_t> allocated_{0};
+
+    std::atomic<size_t> reused_{0};
+};
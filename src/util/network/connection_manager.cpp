@@ -0,0 +1,209 @@
+#include "connection_manager.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "util/logging/logging.h"
+
+ConnectionManager::ConnectionManager(std::string base_url, SocketFactory make_socket)
+    : base_url_(std::move(base_url)), make_socket_(std::move(make_socket)) {
+#ifndef __EMSCRIPTEN__
+    loop_ = std::thread(&ConnectionManager::Run, this);
+#endif
+}
+
+ConnectionManager::~ConnectionManager() {
+#ifndef __EMSCRIPTEN__
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    loop_.join();
+#endif
+    // Close events raised from here on only queue tasks nobody runs
+    for (auto &[path, connection]: connections_) {
+        if (connection.socket != nullptr) connection.socket->close();
+    }
+    connections_.clear();
+    retired_.clear();
+}
+
+void ConnectionManager::Warm(const std::string &path) {
+    Post([this, path] {
+        auto &connection = connections_[path];
+        if (connection.socket == nullptr) Connect(path, connection);
+    });
+}
+
+void ConnectionManager::Request(const std::string &path, std::string payload, Callback done,
+                                const std::chrono::milliseconds timeout) {
+    Post([this, path, pending = Pending{std::move(payload), std::move(done), Clock::now() + timeout}]() mutable {
+        auto &connection = connections_[path];
+        if (connection.open) {
+            reuses_.fetch_add(1, std::memory_order_relaxed);
+            Send(connection, std::move(pending));
+            return;
+        }
+        connection.waiting.push_back(std::move(pending));
+        if (connection.socket == nullptr) Connect(path, connection);
+    });
+}
+
+void ConnectionManager::Poll() {
+#ifdef __EMSCRIPTEN__
+    retired_.clear();
+    ExpireRequests();
+#endif
+    std::function<void()> callback;
+    while (completed_.try_dequeue(callback)) {
+        callback();
+    }
+}
+
+void ConnectionManager::Post(std::function<void()> task) {
+#ifdef __EMSCRIPTEN__
+    task();
+#else
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+#endif
+}
+
+void ConnectionManager::Run() {
+    std::deque<std::function<void()> > batch;
+    while (true) {
+        const auto deadline = NextDeadline();
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait_until(lock, deadline, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) return;
+            batch.swap(tasks_);
+        }
+        for (auto &task: batch) {
+            task();
+        }
+        batch.clear();
+        // Destroying a desktop socket joins its thread, which may be waiting on mutex_ in Post
+        retired_.clear();
+        ExpireRequests();
+    }
+}
+
+void ConnectionManager::Connect(const std::string &path, Connection &connection) {
+    const auto generation = next_generation_++;
+    connection.generation = generation;
+    connection.open = false;
+    connection.socket = make_socket_(base_url_ + path);
+    connection.socket->on_open = [this, path, generation] {
+        Post([this, path, generation] { OnOpen(path, generation); });
+    };
+    connection.socket->on_message = [this, path, generation](const std::string &message) {
+        Post([this, path, generation, message] { OnMessage(path, generation, message); });
+    };
+    connection.socket->on_error = [this, path, generation](const std::string &error) {
+        Post([this, path, generation, error] { OnClosed(path, generation, error); });
+    };
+    connection.socket->on_close = [this, path, generation] {
+        Post([this, path, generation] { OnClosed(path, generation, "connection closed"); });
+    };
+    connects_.fetch_add(1, std::memory_order_relaxed);
+    connection.socket->connect();
+}
+
+void ConnectionManager::Send(Connection &connection, Pending pending) {
+    connection.socket->send(pending.payload);
+    pending.payload.clear();
+    connection.in_flight.push_back(std::move(pending));
+}
+
+void ConnectionManager::OnOpen(const std::string &path, const std::uint64_t generation) {
+    const auto it = connections_.find(path);
+    if (it == connections_.end() || it->second.generation != generation) return;
+    auto &connection = it->second;
+    connection.open = true;
+    while (!connection.waiting.empty()) {
+        auto pending = std::move(connection.waiting.front());
+        connection.waiting.pop_front();
+        Send(connection, std::move(pending));
+    }
+}
+
+void ConnectionManager::OnMessage(const std::string &path, const std::uint64_t generation,
+                                  const std::string &message) {
+    const auto it = connections_.find(path);
+    if (it == connections_.end() || it->second.generation != generation) return;
+    auto &connection = it->second;
+    if (connection.in_flight.empty()) {
+        Logger::instance().warn("Unrequested message on {}", path);
+        return;
+    }
+    Complete(connection.in_flight.front(), Result::Status::Ok, message);
+    connection.in_flight.pop_front();
+}
+
+void ConnectionManager::OnClosed(const std::string &path, const std::uint64_t generation,
+                                 const std::string &reason) {
+    const auto it = connections_.find(path);
+    if (it == connections_.end() || it->second.generation != generation) return;
+    Reset(path, it->second, reason);
+}
+
+void ConnectionManager::Reset(const std::string &path, Connection &connection, const std::string &reason) {
+    for (auto &pending: connection.in_flight) {
+        Complete(pending, Result::Status::Failed, reason);
+    }
+    connection.in_flight.clear();
+    if (!connection.open) {
+        for (auto &pending: connection.waiting) {
+            Complete(pending, Result::Status::Failed, reason);
+        }
+        connection.waiting.clear();
+    }
+    connection.socket->close();
+    retired_.push_back(std::move(connection.socket));
+    connection.generation = 0;
+    connection.open = false;
+    if (!connection.waiting.empty()) Connect(path, connection);
+}
+
+void ConnectionManager::ExpireRequests() {
+    const auto now = Clock::now();
+    for (auto &[path, connection]: connections_) {
+        std::erase_if(connection.waiting, [&](Pending &pending) {
+            if (pending.deadline > now) return false;
+            Complete(pending, Result::Status::TimedOut, "timed out");
+            return true;
+        });
+        const bool expired = std::ranges::any_of(connection.in_flight, [&](const Pending &pending) {
+            return pending.deadline <= now;
+        });
+        if (!expired) continue;
+        for (auto &pending: connection.in_flight) {
+            if (pending.deadline <= now) Complete(pending, Result::Status::TimedOut, "timed out");
+            else Complete(pending, Result::Status::Failed, "connection reset after a timeout");
+        }
+        connection.in_flight.clear();
+        Logger::instance().warn("Request on {} timed out, dropping its connection", path);
+        Reset(path, connection, "timed out");
+    }
+}
+
+ConnectionManager::Clock::time_point ConnectionManager::NextDeadline() const {
+    // Bounded so wait_until never has to convert time_point::max()
+    auto next = Clock::now() + std::chrono::minutes(1);
+    for (const auto &[path, connection]: connections_) {
+        for (const auto &pending: connection.waiting) next = std::min(next, pending.deadline);
+        for (const auto &pending: connection.in_flight) next = std::min(next, pending.deadline);
+    }
+    return next;
+}
+
+void ConnectionManager::Complete(Pending &pending, const Result::Status status, std::string message) {
+    completed_.enqueue([done = std::move(pending.done), result = Result{status, std::move(message)}] {
+        done(result);
+    });
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrentqueue.h"
+#include "sockets/web_socket.h"
+
+/**
+ * Request/response exchanges with one API host over persistent web sockets, one per endpoint path.
+ * A request is one message sent and the next message received on that connection; requests on
+ * the same path are answered in order. Connections stay open between requests and reopen on
+ * demand when the server closes them, so only the first request (or Warm()) pays for the
+ * handshake.
+ *
+ * All connection state lives on one event loop thread; callbacks are queued and run from Poll()
+ * on the main loop, never on a network thread. On Emscripten the browser already delivers socket
+ * events on the main thread, so the loop runs inline there and Poll() also checks the deadlines.
+ *
+ * Destroying the manager closes every connection, joins the loop and drops callbacks not yet
+ * polled, so a callback never outlives its owner as long as the owner outlives the manager.
+ */
+class ConnectionManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    using SocketFactory = std::function<WebSocketImpl::Ptr(const std::string &url)>;
+
+    struct Result {
+        enum class Status {
+            Ok, TimedOut, Failed
+        };
+
+        Status status;
+
+        std::string message; // The response, or what went wrong
+
+        [[nodiscard]] bool Ok() const { return status == Status::Ok; }
+    };
+
+    using Callback = std::function<void(Result)>;
+
+    /**
+     * base_url is prefixed to every path; make_socket creates an unconnected socket for a url.
+     */
+    ConnectionManager(std::string base_url, SocketFactory make_socket);
+
+    ConnectionManager(const ConnectionManager &) = delete;
+
+    ConnectionManager &operator=(const ConnectionManager &) = delete;
+
+    ~ConnectionManager();
+
+    /**
+     * Opens the connection to path ahead of the first request, if it isn't open already.
+     */
+    void Warm(const std::string &path);
+
+    /**
+     * Sends payload on path's connection; done gets the reply, or a failure once timeout passes
+     * without one. A timed out request resets its connection, since a late reply would be taken
+     * for the next request's.
+     */
+    void Request(const std::string &path, std::string payload, Callback done,
+                 std::chrono::milliseconds timeout = std::chrono::seconds(10));
+
+    /**
+     * Runs the callbacks of finished requests. Main thread only.
+     */
+    void Poll();
+
+    /**
+     * Handshakes started. Stays at one per path while the server keeps connections open.
+     */
+    [[nodiscard]] size_t Connects() const { return connects_.load(std::memory_order_relaxed); }
+
+    /**
+     * Requests sent on a connection that was already open.
+     */
+    [[nodiscard]] size_t Reuses() const { return reuses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending {
+        std::string payload;
+        Callback done;
+        Clock::time_point deadline;
+    };
+
+    struct Connection {
+        WebSocketImpl::Ptr socket;
+        std::uint64_t generation{0}; // Tells events of this socket from those of one it replaced
+        bool open{false};
+        std::deque<Pending> waiting; // Until the socket opens
+        std::deque<Pending> in_flight; // Sent, answered in order
+    };
+
+    /**
+     * Runs task on the loop: queued for the loop thread, or right away on Emscripten.
+     */
+    void Post(std::function<void()> task);
+
+    void Run();
+
+    void Connect(const std::string &path, Connection &connection);
+
+    void Send(Connection &connection, Pending pending);
+
+    void OnOpen(const std::string &path, std::uint64_t generation);
+
+    void OnMessage(const std::string &path, std::uint64_t generation, const std::string &message);
+
+    void OnClosed(const std::string &path, std::uint64_t generation, const std::string &reason);
+
+    /**
+     * Drops connection's socket and fails what was sent on it. Waiting requests reconnect, unless
+     * the socket never opened, in which case they fail too.
+     */
+    void Reset(const std::string &path, Connection &connection, const std::string &reason);
+
+    void ExpireRequests();
+
+    [[nodiscard]] Clock::time_point NextDeadline() const;
+
+    void Complete(Pending &pending, Result::Status status, std::string message);
+
+    std::string base_url_;
+
+    SocketFactory make_socket_;
+
+    std::map<std::string, Connection> connections_; // Loop only
+
+    std::vector<WebSocketImpl::Ptr> retired_; // Reset sockets, freed outside their own callbacks
+
+    std::uint64_t next_generation_{1}; // Loop only
+
+    std::mutex mutex_;
+
+    std::condition_variable wake_;
+
+    std::deque<std::function<void()> > tasks_; // Guarded by mutex_
+
+    bool stopping_{false}; // Guarded by mutex_
+
+    moodycamel::ConcurrentQueue<std::function<void()> > completed_;
+
+    std::atomic<size_t> connects_{0};
+
+    std::atomic<size_t> reuses_{0};
+
+    std::thread loop_; // Last, so it starts after everything above exists
+};
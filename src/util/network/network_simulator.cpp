@@ -0,0 +1,317 @@
+#include "network_simulator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "util/filesystem/filesystem.h"
+
+namespace {
+    NetworkConditions symmetric(const float latency_ms, const float jitter_ms, const float up_kbps,
+                                const float down_kbps, const float drop_rate, const float reorder_rate) {
+        return NetworkConditions{
+            true,
+            LinkConditions{latency_ms, jitter_ms, up_kbps, drop_rate, reorder_rate},
+            LinkConditions{latency_ms, jitter_ms, down_kbps, drop_rate, reorder_rate},
+        };
+    }
+}
+
+const std::vector<NetworkPreset> &network_presets() {
+    static const std::vector<NetworkPreset> presets{
+        {"Off", NetworkConditions{}},
+        {"Wi-Fi", symmetric(10, 5, 20000, 50000, 0, 0)},
+        {"4G", symmetric(35, 20, 5000, 20000, 0, 0)},
+        {"3G", symmetric(100, 60, 750, 1600, 0.005f, 0)},
+        {"Congested", symmetric(150, 150, 400, 1000, 0.03f, 0.02f)},
+    };
+    return presets;
+}
+
+bool load_network_conditions(const std::string &path, NetworkConditions &out) {
+    std::string contents;
+    if (!read_file(path, contents)) return false;
+    try {
+        out = deserialize<NetworkConditions>(contents);
+        return true;
+    } catch (const nlohmann::json::exception &) {
+        return false;
+    }
+}
+
+bool save_network_conditions(const std::string &path, const NetworkConditions &conditions) {
+    return write_file(path, nlohmann::json(conditions).dump(4));
+}
+
+struct NetworkSimulator::Link {
+    std::mutex mutex; // Held while calling outer's callbacks, and by the socket while it detaches
+
+    Socket *outer{nullptr}; // Null once the socket is gone
+
+    // Not owned: a desktop socket joins its thread when destroyed, which can't happen on that
+    // thread or under mutex (its own callbacks may be waiting for it)
+    std::weak_ptr<WebSocketImpl> inner;
+
+    std::atomic<size_t> pending[2]{0, 0}; // Events held back, by direction
+
+    // Simulator mutex only
+    Clock::time_point busy_until[2]{}; // End of the last transfer, for the bandwidth cap
+
+    Clock::time_point last_due[2]{}; // Keeps delivery in order
+};
+
+/**
+ * What Wrap() returns. The real socket's callbacks feed the simulator, which calls this one's.
+ */
+class NetworkSimulator::Socket : public WebSocketImpl {
+public:
+    Socket(std::shared_ptr<NetworkSimulator> simulator, Ptr inner)
+        : simulator_(std::move(simulator)), inner_(std::move(inner)), link_(std::make_shared<Link>()) {
+        link_->outer = this;
+        link_->inner = inner_;
+        // The callbacks share the link, not this; a late event finds it detached and is dropped
+        auto *simulator_ptr = simulator_.get();
+        auto link = link_;
+        inner_->on_open = [simulator_ptr, link] {
+            simulator_ptr->Forward(link, Direction::Down, true, {}, [](Link &l, const std::string &) {
+                if (l.outer->on_open) l.outer->on_open();
+            });
+        };
+        inner_->on_message = [simulator_ptr, link](const std::string &message) {
+            simulator_ptr->Forward(link, Direction::Down, false, message, [](Link &l, const std::string &payload) {
+                if (l.outer->on_message) l.outer->on_message(payload);
+            });
+        };
+        inner_->on_binary_message = [simulator_ptr, link](const std::string &message) {
+            simulator_ptr->Forward(link, Direction::Down, false, message, [](Link &l, const std::string &payload) {
+                if (l.outer->on_binary_message) l.outer->on_binary_message(payload);
+                else if (l.outer->on_message) l.outer->on_message(payload);
+            });
+        };
+        inner_->on_close = [simulator_ptr, link] {
+            simulator_ptr->Forward(link, Direction::Down, true, {}, [](Link &l, const std::string &) {
+                if (l.outer->on_close) l.outer->on_close();
+            });
+        };
+        inner_->on_error = [simulator_ptr, link](const std::string &error) {
+            simulator_ptr->Forward(link, Direction::Down, true, error, [](Link &l, const std::string &payload) {
+                if (l.outer->on_error) l.outer->on_error(payload);
+            });
+        };
+    }
+
+    ~Socket() override {
+        std::lock_guard lock(link_->mutex);
+        link_->outer = nullptr;
+    }
+
+    void connect() override {
+        // Half the handshake; the other half is on_open coming back
+        simulator_->Forward(link_, Direction::Up, true, {}, [](Link &l, const std::string &) {
+            if (const auto inner = l.inner.lock()) inner->connect();
+        });
+    }
+
+    void send(const std::string &message) override {
+        simulator_->Forward(link_, Direction::Up, false, message, [](Link &l, const std::string &payload) {
+            if (const auto inner = l.inner.lock()) inner->send(payload);
+        });
+    }
+
+    void send_binary(const std::string &message) override {
+        simulator_->Forward(link_, Direction::Up, false, message, [](Link &l, const std::string &payload) {
+            if (const auto inner = l.inner.lock()) inner->send_binary(payload);
+        });
+    }
+
+    void close() override {
+        simulator_->Forward(link_, Direction::Up, true, {}, [](Link &l, const std::string &) {
+            if (const auto inner = l.inner.lock()) inner->close();
+        });
+    }
+
+    [[nodiscard]] const std::shared_ptr<Link> &GetLink() const { return link_; }
+
+private:
+    std::shared_ptr<NetworkSimulator> simulator_;
+
+    Ptr inner_;
+
+    std::shared_ptr<Link> link_;
+};
+
+NetworkSimulator::NetworkSimulator(NetworkConditions conditions)
+    : conditions_(conditions), enabled_(conditions.enabled), rng_(std::random_device{}()) {
+#ifndef __EMSCRIPTEN__
+    thread_ = std::thread(&NetworkSimulator::Run, this);
+#endif
+}
+
+NetworkSimulator::~NetworkSimulator() {
+#ifndef __EMSCRIPTEN__
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+#endif
+}
+
+WebSocketImpl::Ptr NetworkSimulator::Wrap(WebSocketImpl::Ptr inner) {
+    auto socket = std::make_shared<Socket>(shared_from_this(), std::move(inner));
+    std::lock_guard lock(mutex_);
+    std::erase_if(links_, [](const std::weak_ptr<Link> &link) { return link.expired(); });
+    links_.push_back(socket->GetLink());
+    return socket;
+}
+
+std::function<WebSocketImpl::Ptr(const std::string &)> NetworkSimulator::Factory(
+    std::function<WebSocketImpl::Ptr(const std::string &)> make_socket) {
+    return [simulator = shared_from_this(), make_socket = std::move(make_socket)](const std::string &url) {
+        return simulator->Wrap(make_socket(url));
+    };
+}
+
+void NetworkSimulator::SetConditions(const NetworkConditions &conditions) {
+    std::lock_guard lock(mutex_);
+    conditions_ = conditions;
+    enabled_.store(conditions.enabled, std::memory_order_relaxed);
+}
+
+NetworkConditions NetworkSimulator::Conditions() const {
+    std::lock_guard lock(mutex_);
+    return conditions_;
+}
+
+void NetworkSimulator::DropConnections() {
+    std::vector<std::shared_ptr<Link> > live;
+    {
+        std::lock_guard lock(mutex_);
+        for (const auto &weak: links_) {
+            if (auto link = weak.lock()) live.push_back(std::move(link));
+        }
+    }
+    for (const auto &link: live) {
+        if (const auto inner = link->inner.lock()) inner->close();
+    }
+}
+
+void NetworkSimulator::Pump() {
+#ifdef __EMSCRIPTEN__
+    std::vector<Event> due;
+    {
+        std::lock_guard lock(mutex_);
+        TakeDue(Clock::now(), due);
+    }
+    for (auto &event: due) {
+        Deliver(event);
+    }
+#endif
+}
+
+size_t NetworkSimulator::InFlight() const {
+    std::lock_guard lock(mutex_);
+    return events_.size();
+}
+
+size_t NetworkSimulator::Sockets() const {
+    std::lock_guard lock(mutex_);
+    return std::ranges::count_if(links_, [](const std::weak_ptr<Link> &link) { return !link.expired(); });
+}
+
+bool NetworkSimulator::PassThrough(const Link &link, const Direction direction) const {
+    return !enabled_.load(std::memory_order_relaxed) &&
+           link.pending[static_cast<int>(direction)].load(std::memory_order_acquire) == 0;
+}
+
+void NetworkSimulator::Forward(const std::shared_ptr<Link> &link, const Direction direction, const bool control,
+                               const std::string &payload, const DeliverFn deliver) {
+    if (!PassThrough(*link, direction)) {
+        Schedule(link, direction, control, payload, deliver);
+        return;
+    }
+    if (direction == Direction::Up) {
+        deliver(*link, payload);
+        return;
+    }
+    std::lock_guard lock(link->mutex);
+    if (link->outer != nullptr) deliver(*link, payload);
+}
+
+void NetworkSimulator::Schedule(const std::shared_ptr<Link> &link, const Direction direction, const bool control,
+                                const std::string &payload, const DeliverFn deliver) {
+    using Millis = std::chrono::duration<float, std::milli>;
+    const int d = static_cast<int>(direction);
+    std::lock_guard lock(mutex_);
+    // Disabled with events still held back: no delay, just stay behind them
+    const auto conditions = conditions_.enabled
+                                ? direction == Direction::Up ? conditions_.upstream : conditions_.downstream
+                                : LinkConditions{};
+    std::uniform_real_distribution<float> unit(0, 1);
+    if (!control && conditions.drop_rate > 0 && unit(rng_) < conditions.drop_rate) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const auto now = Clock::now();
+    auto sent = now;
+    if (!control && conditions.bandwidth_kbps > 0) {
+        const auto start = std::max(now, link->busy_until[d]);
+        const float transfer_ms = static_cast<float>(payload.size()) * 8.0f / conditions.bandwidth_kbps;
+        link->busy_until[d] = start + std::chrono::duration_cast<Clock::duration>(Millis(transfer_ms));
+        sent = link->busy_until[d];
+    }
+    const float delay_ms = conditions.latency_ms + conditions.jitter_ms * unit(rng_);
+    auto due = sent + std::chrono::duration_cast<Clock::duration>(Millis(delay_ms));
+    if (!control && conditions.reorder_rate > 0 && unit(rng_) < conditions.reorder_rate) {
+        // Held back past the ones behind it, without holding them up
+        const float extra_ms = std::max(20.0f, conditions.latency_ms + conditions.jitter_ms);
+        due += std::chrono::duration_cast<Clock::duration>(Millis(extra_ms));
+        reordered_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        due = std::max(due, link->last_due[d]);
+        link->last_due[d] = due;
+    }
+    link->pending[d].fetch_add(1, std::memory_order_release);
+    events_.push_back(Event{due, next_sequence_++, link, direction, deliver, payload});
+    std::ranges::push_heap(events_, std::greater<>{});
+    delayed_.fetch_add(1, std::memory_order_relaxed);
+    wake_.notify_one();
+}
+
+void NetworkSimulator::Run() {
+    std::vector<Event> due;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            while (!stopping_ && (events_.empty() || events_.front().due > Clock::now())) {
+                if (events_.empty()) wake_.wait(lock);
+                else wake_.wait_until(lock, events_.front().due);
+            }
+            if (stopping_) return;
+            TakeDue(Clock::now(), due);
+        }
+        for (auto &event: due) {
+            Deliver(event);
+        }
+        due.clear();
+    }
+}
+
+void NetworkSimulator::TakeDue(const Clock::time_point now, std::vector<Event> &out) {
+    while (!events_.empty() && events_.front().due <= now) {
+        std::ranges::pop_heap(events_, std::greater<>{});
+        out.push_back(std::move(events_.back()));
+        events_.pop_back();
+    }
+}
+
+void NetworkSimulator::Deliver(Event &event) {
+    auto &link = *event.link;
+    if (event.direction == Direction::Up) {
+        event.deliver(link, event.payload);
+    } else {
+        std::lock_guard lock(link.mutex);
+        if (link.outer != nullptr) event.deliver(link, event.payload);
+    }
+    link.pending[static_cast<int>(event.direction)].fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sockets/web_socket.h"
+#include "util/serialization/serialization.h"
+
+/**
+ * One direction of a simulated link. Zero means no effect.
+ */
+struct LinkConditions {
+    float latency_ms{0}; // One way
+    float jitter_ms{0}; // Uniform extra delay on top of latency; order is kept, like TCP
+    float bandwidth_kbps{0}; // Messages queue behind each other at this rate
+    float drop_rate{0}; // Fraction of messages lost outright (open/close/errors are never dropped)
+    float reorder_rate{0}; // Fraction of messages held back an extra latency, letting later ones pass
+
+    bool operator==(const LinkConditions &) const = default;
+};
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
+    LinkConditions,
+    latency_ms,
+    jitter_ms,
+    bandwidth_kbps,
+    drop_rate,
+    reorder_rate
+)
+
+struct NetworkConditions {
+    bool enabled{false};
+    LinkConditions upstream; // Client to server
+    LinkConditions downstream; // Server to client
+
+    bool operator==(const NetworkConditions &) const = default;
+};
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(NetworkConditions, enabled, upstream, downstream)
+
+struct NetworkPreset {
+    const char *name;
+    NetworkConditions conditions;
+};
+
+/**
+ * Typical home Wi-Fi, mobile and bad-network profiles, for the debug window.
+ */
+const std::vector<NetworkPreset> &network_presets();
+
+/**
+ * Reads conditions from a JSON file like {"enabled": true, "downstream": {"latency_ms": 80}}.
+ * Missing fields keep their defaults. False if the file can't be read or parsed.
+ */
+bool load_network_conditions(const std::string &path, NetworkConditions &out);
+
+bool save_network_conditions(const std::string &path, const NetworkConditions &conditions);
+
+/**
+ * Wraps web sockets to put a simulated network between them and their owner: latency, jitter,
+ * a bandwidth cap, reordering and message loss, set separately for each direction and
+ * changeable at any time. Outgoing messages are held before reaching the real socket, incoming
+ * ones (and open/close/error events) before reaching the owner's callbacks.
+ *
+ * Delayed events are delivered from the simulator's own thread, or from Pump() on Emscripten,
+ * where socket calls have to stay on the main thread. While disabled, sockets pass everything
+ * straight through once what was already held back has gone.
+ *
+ * Always owned by a shared_ptr; wrapped sockets keep it alive.
+ */
+class NetworkSimulator : public std::enable_shared_from_this<NetworkSimulator> {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit NetworkSimulator(NetworkConditions conditions = {});
+
+    NetworkSimulator(const NetworkSimulator &) = delete;
+
+    NetworkSimulator &operator=(const NetworkSimulator &) = delete;
+
+    ~NetworkSimulator();
+
+    /**
+     * inner behind the simulated network. Use in place of inner; it must not have been connected
+     * yet, and its callbacks belong to the wrapper from now on.
+     */
+    WebSocketImpl::Ptr Wrap(WebSocketImpl::Ptr inner);
+
+    /**
+     * A socket factory wrapping what make_socket returns.
+     */
+    std::function<WebSocketImpl::Ptr(const std::string &)> Factory(
+        std::function<WebSocketImpl::Ptr(const std::string &)> make_socket);
+
+    void SetConditions(const NetworkConditions &conditions);
+
+    [[nodiscard]] NetworkConditions Conditions() const;
+
+    /**
+     * Closes every wrapped socket, as if the network went away.
+     */
+    void DropConnections();
+
+    /**
+     * Delivers what is due. Needed on Emscripten only; call it every frame.
+     */
+    void Pump();
+
+    [[nodiscard]] size_t Delayed() const { return delayed_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t Reordered() const { return reordered_.load(std::memory_order_relaxed); }
+
+    /**
+     * Messages and events held back right now.
+     */
+    [[nodiscard]] size_t InFlight() const;
+
+    [[nodiscard]] size_t Sockets() const;
+
+private:
+    enum class Direction {
+        Up, Down
+    };
+
+    struct Link;
+
+    class Socket;
+
+    using DeliverFn = void (*)(Link &link, const std::string &payload);
+
+    struct Event {
+        Clock::time_point due;
+        std::uint64_t sequence; // Ties broken in send order
+        std::shared_ptr<Link> link;
+        Direction direction;
+        DeliverFn deliver;
+        std::string payload;
+
+        bool operator>(const Event &other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * True if events can skip the queue: nothing simulated, nothing held back in direction.
+     */
+    [[nodiscard]] bool PassThrough(const Link &link, Direction direction) const;
+
+    /**
+     * Sends an event across link: right away if it can pass through, otherwise when the
+     * conditions say. control events (connect, open, close, error) are delayed but never dropped.
+     */
+    void Forward(const std::shared_ptr<Link> &link, Direction direction, bool control, const std::string &payload,
+                 DeliverFn deliver);
+
+    void Schedule(const std::shared_ptr<Link> &link, Direction direction, bool control, const std::string &payload,
+                  DeliverFn deliver);
+
+    void Run();
+
+    /**
+     * Pops every event due by now into out.
+     */
+    void TakeDue(Clock::time_point now, std::vector<Event> &out);
+
+    static void Deliver(Event &event);
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable wake_;
+
+    NetworkConditions conditions_;
+
+    std::atomic<bool> enabled_;
+
+    std::vector<Event> events_; // Heap, soonest first
+
+    std::uint64_t next_sequence_{0};
+
+    std::vector<std::weak_ptr<Link> > links_;
+
+    std::mt19937 rng_;
+
+    bool stopping_{false};
+
+    std::atomic<size_t> delayed_{0};
+
+    std::atomic<size_t> dropped_{0};
+
+    std::atomic<size_t> reordered_{0};
+
+#ifndef __EMSCRIPTEN__
+    std::thread thread_;
+#endif
+};
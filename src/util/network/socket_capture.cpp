@@ -0,0 +1,371 @@
+#include "socket_capture.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+    const std::string capture_magic = "pscap1\n";
+
+    void put_varint(std::string &out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool get_varint(const std::string &data, size_t &pos, std::uint64_t &out) {
+        out = 0;
+        for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+            const auto byte = static_cast<unsigned char>(data[pos++]);
+            out |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+}
+
+bool read_capture(const std::string &path, std::vector<CaptureRecord> &out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    const std::string data{std::istreambuf_iterator(in), std::istreambuf_iterator<char>()};
+    if (data.compare(0, capture_magic.size(), capture_magic) != 0) return false;
+    size_t pos = capture_magic.size();
+    std::int64_t micros = 0;
+    while (pos < data.size()) {
+        std::uint64_t delta, socket, length;
+        if (!get_varint(data, pos, delta) || !get_varint(data, pos, socket) || pos >= data.size()) break;
+        const auto event = static_cast<CaptureEvent>(data[pos++]);
+        if (!get_varint(data, pos, length) || length > data.size() - pos) break;
+        micros += static_cast<std::int64_t>(delta);
+        out.push_back({micros, static_cast<std::uint32_t>(socket), event, data.substr(pos, length)});
+        pos += length;
+    }
+    return true;
+}
+
+std::string capture_url_path(const std::string &url) {
+    const auto scheme = url.find("://");
+    const auto slash = url.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+    return slash == std::string::npos ? "/" : url.substr(slash);
+}
+
+/**
+ * What SocketRecorder::Wrap() returns: inner, with everything noted on the way through.
+ */
+class SocketRecorder::Socket : public WebSocketImpl {
+public:
+    Socket(std::shared_ptr<SocketRecorder> recorder, const std::uint32_t id, Ptr inner)
+        : recorder_(std::move(recorder)), id_(id), inner_(std::move(inner)) {
+        // inner_ goes first when this is destroyed, so its callbacks can't outlive this
+        inner_->on_open = [this] {
+            recorder_->Record(id_, CaptureEvent::Open, {});
+            if (on_open) on_open();
+        };
+        inner_->on_message = [this](const std::string &message) {
+            recorder_->Record(id_, CaptureEvent::Received, message);
+            if (on_message) on_message(message);
+        };
+        inner_->on_binary_message = [this](const std::string &message) {
+            recorder_->Record(id_, CaptureEvent::ReceivedBinary, message);
+            if (on_binary_message) on_binary_message(message);
+            else if (on_message) on_message(message);
+        };
+        inner_->on_close = [this] {
+            recorder_->Record(id_, CaptureEvent::Closed, {});
+            if (on_close) on_close();
+        };
+        inner_->on_error = [this](const std::string &error) {
+            recorder_->Record(id_, CaptureEvent::Error, error);
+            if (on_error) on_error(error);
+        };
+    }
+
+    void connect() override {
+        recorder_->Record(id_, CaptureEvent::Connect, {});
+        inner_->connect();
+    }
+
+    void send(const std::string &message) override {
+        recorder_->Record(id_, CaptureEvent::Sent, message);
+        inner_->send(message);
+    }
+
+    void send_binary(const std::string &message) override {
+        recorder_->Record(id_, CaptureEvent::SentBinary, message);
+        inner_->send_binary(message);
+    }
+
+    void close() override {
+        recorder_->Record(id_, CaptureEvent::Close, {});
+        inner_->close();
+    }
+
+private:
+    std::shared_ptr<SocketRecorder> recorder_;
+
+    std::uint32_t id_;
+
+    Ptr inner_;
+};
+
+std::shared_ptr<SocketRecorder> SocketRecorder::Open(const std::string &path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return nullptr;
+    return std::make_shared<SocketRecorder>(std::move(out));
+}
+
+SocketRecorder::SocketRecorder(std::ofstream out)
+    : out_(std::move(out)), start_(Clock::now()), last_flush_(start_) {
+    out_ << capture_magic;
+}
+
+SocketRecorder::~SocketRecorder() {
+    out_.flush();
+}
+
+WebSocketImpl::Ptr SocketRecorder::Wrap(const std::string &url, WebSocketImpl::Ptr inner) {
+    const auto id = next_socket_.fetch_add(1, std::memory_order_relaxed);
+    Record(id, CaptureEvent::Created, url);
+    return std::make_shared<Socket>(shared_from_this(), id, std::move(inner));
+}
+
+std::function<WebSocketImpl::Ptr(const std::string &)> SocketRecorder::Factory(
+    std::function<WebSocketImpl::Ptr(const std::string &)> make_socket) {
+    return [recorder = shared_from_this(), make_socket = std::move(make_socket)](const std::string &url) {
+        return recorder->Wrap(url, make_socket(url));
+    };
+}
+
+void SocketRecorder::Record(const std::uint32_t socket, const CaptureEvent event, const std::string &payload) {
+    std::lock_guard lock(mutex_);
+    const auto now = Clock::now();
+    // Taken under the lock, so records are in time order even across threads
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+    scratch_.clear();
+    put_varint(scratch_, static_cast<std::uint64_t>(micros - last_micros_));
+    put_varint(scratch_, socket);
+    scratch_.push_back(static_cast<char>(event));
+    put_varint(scratch_, payload.size());
+    out_.write(scratch_.data(), static_cast<std::streamsize>(scratch_.size()));
+    out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    last_micros_ = micros;
+    const bool closing = event == CaptureEvent::Closed || event == CaptureEvent::Close;
+    if (closing || now - last_flush_ > std::chrono::seconds(1)) {
+        out_.flush();
+        last_flush_ = now;
+    }
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(scratch_.size() + payload.size(), std::memory_order_relaxed);
+}
+
+/**
+ * What CaptureReplay::Factory() makes. Everything but the callbacks is guarded by the replay's
+ * mutex.
+ */
+class CaptureReplay::Socket : public WebSocketImpl, public std::enable_shared_from_this<Socket> {
+public:
+    Socket(std::shared_ptr<CaptureReplay> replay, std::string path)
+        : replay(std::move(replay)), path(std::move(path)) {
+    }
+
+    void connect() override {
+        std::lock_guard lock(replay->mutex_);
+        if (connected) return;
+        connected = true;
+        connected_at = Clock::now();
+        recording = replay->Claim(path);
+        replay->sockets_.push_back(weak_from_this());
+    }
+
+    void send(const std::string &) override {
+        Sent();
+    }
+
+    void send_binary(const std::string &) override {
+        Sent();
+    }
+
+    void close() override {
+        std::lock_guard lock(replay->mutex_);
+        closed = true;
+    }
+
+    std::shared_ptr<CaptureReplay> replay;
+
+    std::string path;
+
+    Recording *recording{nullptr};
+
+    size_t next{0}; // Into recording->inbound
+
+    size_t sends{0};
+
+    bool connected{false};
+
+    bool closed{false};
+
+    Clock::time_point connected_at;
+
+    Clock::time_point first_send_at;
+
+private:
+    void Sent() {
+        replay->sent_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(replay->mutex_);
+        if (sends++ == 0) first_send_at = Clock::now();
+    }
+};
+
+std::shared_ptr<CaptureReplay> CaptureReplay::Load(const std::string &path, const float speed) {
+    std::vector<CaptureRecord> records;
+    if (!read_capture(path, records)) return nullptr;
+    return std::make_shared<CaptureReplay>(std::move(records), speed);
+}
+
+CaptureReplay::CaptureReplay(std::vector<CaptureRecord> records, const float speed)
+    : records_(std::move(records)), speed_(speed) {
+    std::unordered_map<std::uint32_t, size_t> by_socket;
+    for (const auto &record: records_) {
+        if (record.event == CaptureEvent::Created) {
+            by_socket[record.socket] = recordings_.size();
+            Recording recording;
+            recording.path = capture_url_path(record.payload);
+            recording.connect_micros = record.micros;
+            recordings_.push_back(std::move(recording));
+            continue;
+        }
+        const auto it = by_socket.find(record.socket);
+        if (it == by_socket.end()) continue;
+        auto &recording = recordings_[it->second];
+        switch (record.event) {
+            case CaptureEvent::Connect:
+                recording.connect_micros = record.micros;
+                break;
+            case CaptureEvent::Sent:
+            case CaptureEvent::SentBinary:
+                if (recording.gated_from == SIZE_MAX) {
+                    recording.gated_from = recording.inbound.size();
+                    recording.first_send_micros = record.micros;
+                }
+                break;
+            case CaptureEvent::Received:
+            case CaptureEvent::ReceivedBinary:
+                recorded_messages_++;
+                [[fallthrough]];
+            case CaptureEvent::Open:
+            case CaptureEvent::Closed:
+            case CaptureEvent::Error:
+                recording.inbound.push_back(&record);
+                break;
+            case CaptureEvent::Created:
+            case CaptureEvent::Close:
+                break;
+        }
+    }
+}
+
+std::function<WebSocketImpl::Ptr(const std::string &)> CaptureReplay::Factory() {
+    return [replay = shared_from_this()](const std::string &url) -> WebSocketImpl::Ptr {
+        return std::make_shared<Socket>(replay, capture_url_path(url));
+    };
+}
+
+void CaptureReplay::Pump() {
+    struct Delivery {
+        std::shared_ptr<Socket> socket;
+        const CaptureRecord *record; // Null: nothing recorded for this socket
+    };
+    std::vector<Delivery> due;
+    {
+        std::lock_guard lock(mutex_);
+        const auto now = Clock::now();
+        std::erase_if(sockets_, [&](const std::weak_ptr<Socket> &weak) {
+            const auto socket = weak.lock();
+            if (socket == nullptr || socket->closed) return true;
+            if (socket->recording == nullptr) {
+                due.push_back({socket, nullptr});
+                return true;
+            }
+            const auto &inbound = socket->recording->inbound;
+            while (socket->next < inbound.size()) {
+                if (socket->next >= socket->recording->gated_from && socket->sends == 0) break;
+                if (Due(*socket, socket->next) > now) break;
+                due.push_back({socket, inbound[socket->next++]});
+            }
+            return socket->next == inbound.size();
+        });
+    }
+    // Outside the lock: the owner may send or close from its callbacks
+    for (const auto &[socket, record]: due) {
+        {
+            std::lock_guard lock(mutex_);
+            if (socket->closed) continue;
+        }
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        if (record == nullptr) {
+            if (socket->on_error) socket->on_error("no recorded socket left for " + socket->path);
+            continue;
+        }
+        switch (record->event) {
+            case CaptureEvent::Open:
+                if (socket->on_open) socket->on_open();
+                break;
+            case CaptureEvent::Received:
+                if (socket->on_message) socket->on_message(record->payload);
+                break;
+            case CaptureEvent::ReceivedBinary:
+                if (socket->on_binary_message) socket->on_binary_message(record->payload);
+                else if (socket->on_message) socket->on_message(record->payload);
+                break;
+            case CaptureEvent::Closed:
+                if (socket->on_close) socket->on_close();
+                break;
+            case CaptureEvent::Error:
+                if (socket->on_error) socket->on_error(record->payload);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void CaptureReplay::SetSpeed(const float speed) {
+    std::lock_guard lock(mutex_);
+    speed_ = speed;
+}
+
+float CaptureReplay::Speed() const {
+    std::lock_guard lock(mutex_);
+    return speed_;
+}
+
+size_t CaptureReplay::Remaining() const {
+    std::lock_guard lock(mutex_);
+    size_t remaining = std::ranges::count_if(recordings_, [](const Recording &r) { return !r.used; });
+    for (const auto &weak: sockets_) {
+        if (const auto socket = weak.lock(); socket != nullptr && socket->recording != nullptr) {
+            remaining += socket->recording->inbound.size() - socket->next;
+        }
+    }
+    return remaining;
+}
+
+CaptureReplay::Recording *CaptureReplay::Claim(const std::string &path) {
+    const auto it = std::ranges::find_if(recordings_, [&](const Recording &r) { return !r.used && r.path == path; });
+    if (it == recordings_.end()) return nullptr;
+    it->used = true;
+    return &*it;
+}
+
+CaptureReplay::Clock::time_point CaptureReplay::Due(const Socket &socket, const size_t index) const {
+    const auto &recording = *socket.recording;
+    const bool gated = index >= recording.gated_from;
+    const auto start = gated ? socket.first_send_at : socket.connected_at;
+    if (speed_ <= 0) return start;
+    const auto origin = gated ? recording.first_send_micros : recording.connect_micros;
+    const auto since = std::max<std::int64_t>(recording.inbound[index]->micros - origin, 0);
+    return start + std::chrono::microseconds(static_cast<std::int64_t>(static_cast<double>(since) / speed_));
+}
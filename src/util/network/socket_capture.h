@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sockets/web_socket.h"
+
+enum class CaptureEvent : std::uint8_t {
+    Created, // payload is the url
+    Connect,
+    Open,
+    Received,
+    ReceivedBinary,
+    Sent,
+    SentBinary,
+    Close, // By the owner
+    Closed, // By the other end, or after Close
+    Error, // payload is the reason
+};
+
+struct CaptureRecord {
+    std::int64_t micros; // Since recording started, monotonic
+    std::uint32_t socket; // Numbered from 1 in the order they were created
+    CaptureEvent event;
+    std::string payload;
+};
+
+/**
+ * Reads a whole capture written by SocketRecorder. A record cut short at the end (the recording
+ * process died mid-write) is left out. False if the file can't be read or isn't a capture.
+ */
+bool read_capture(const std::string &path, std::vector<CaptureRecord> &out);
+
+/**
+ * The path part of a url, e.g. "/ws/account/login" for "wss://host/ws/account/login"; sockets
+ * are matched on it at replay time, so a capture replays against any host.
+ */
+std::string capture_url_path(const std::string &url);
+
+/**
+ * Wraps web sockets to write everything that happens on them to a capture file: creation,
+ * connect, open, every message in and out, close and errors, with monotonic timestamps. Records
+ * are appended as they happen (varint-framed, a few bytes of overhead each), so a crash only
+ * loses what was still buffered.
+ *
+ * Captures hold exactly what crossed the sockets, tokens and login replies included; treat them
+ * like credentials.
+ *
+ * Always owned by a shared_ptr; wrapped sockets keep it alive.
+ */
+class SocketRecorder : public std::enable_shared_from_this<SocketRecorder> {
+public:
+    /**
+     * Null if path can't be written.
+     */
+    static std::shared_ptr<SocketRecorder> Open(const std::string &path);
+
+    explicit SocketRecorder(std::ofstream out);
+
+    SocketRecorder(const SocketRecorder &) = delete;
+
+    SocketRecorder &operator=(const SocketRecorder &) = delete;
+
+    ~SocketRecorder();
+
+    /**
+     * inner, recorded. Use in place of inner; its callbacks belong to the wrapper from now on.
+     */
+    WebSocketImpl::Ptr Wrap(const std::string &url, WebSocketImpl::Ptr inner);
+
+    /**
+     * A socket factory recording what make_socket returns.
+     */
+    std::function<WebSocketImpl::Ptr(const std::string &)> Factory(
+        std::function<WebSocketImpl::Ptr(const std::string &)> make_socket);
+
+    [[nodiscard]] size_t Records() const { return records_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t Bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    class Socket;
+
+    void Record(std::uint32_t socket, CaptureEvent event, const std::string &payload);
+
+    std::mutex mutex_;
+
+    std::ofstream out_; // Guarded by mutex_
+
+    std::string scratch_; // One record, encoded; guarded by mutex_
+
+    Clock::time_point start_;
+
+    std::int64_t last_micros_{0}; // Guarded by mutex_
+
+    Clock::time_point last_flush_; // Guarded by mutex_
+
+    std::atomic<std::uint32_t> next_socket_{1};
+
+    std::atomic<size_t> records_{0};
+
+    std::atomic<size_t> bytes_{0};
+};
+
+/**
+ * Plays a capture back through sockets that never touch the network. Each socket the game
+ * creates takes the next unused recorded socket with the same url path and, once connected,
+ * gets that socket's open, messages, errors and close with the original spacing divided by
+ * speed (0 for no waiting at all). What the game sends is counted and otherwise ignored.
+ *
+ * Recorded replies to the socket's first message (the login, or the game socket's token) wait
+ * for the replayed socket to send its own first message, and are timed from it, so a slow click
+ * doesn't have a reply arrive before its request.
+ *
+ * Events are delivered from Pump(), on whatever thread calls it, which makes runs repeatable:
+ * the same capture and speed give the same messages in the same frames' order. A socket with no
+ * recording left fails with an error.
+ *
+ * Always owned by a shared_ptr; replay sockets keep it alive.
+ */
+class CaptureReplay : public std::enable_shared_from_this<CaptureReplay> {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Null if path isn't a readable capture.
+     */
+    static std::shared_ptr<CaptureReplay> Load(const std::string &path, float speed = 1.0f);
+
+    CaptureReplay(std::vector<CaptureRecord> records, float speed);
+
+    CaptureReplay(const CaptureReplay &) = delete;
+
+    CaptureReplay &operator=(const CaptureReplay &) = delete;
+
+    /**
+     * Makes replay sockets; a drop-in for a real socket factory.
+     */
+    std::function<WebSocketImpl::Ptr(const std::string &)> Factory();
+
+    /**
+     * Delivers every event due by now.
+     */
+    void Pump();
+
+    void SetSpeed(float speed);
+
+    [[nodiscard]] float Speed() const;
+
+    /**
+     * Messages and events delivered so far.
+     */
+    [[nodiscard]] size_t Delivered() const { return delivered_.load(std::memory_order_relaxed); }
+
+    /**
+     * Messages the game sent, for comparing against the recording's.
+     */
+    [[nodiscard]] size_t Sent() const { return sent_.load(std::memory_order_relaxed); }
+
+    /**
+     * Recorded sockets not replayed yet, and events still to deliver on those that are.
+     */
+    [[nodiscard]] size_t Remaining() const;
+
+    /**
+     * Recorded messages received, over all sockets.
+     */
+    [[nodiscard]] size_t RecordedMessages() const { return recorded_messages_; }
+
+private:
+    class Socket;
+
+    struct Recording {
+        std::string path;
+        std::int64_t connect_micros{0};
+        std::int64_t first_send_micros{0};
+        std::vector<const CaptureRecord *> inbound; // Open, messages, errors and close, in order
+        size_t gated_from{SIZE_MAX}; // inbound from here on came after the first send
+        bool used{false};
+    };
+
+    /**
+     * The next unused recording for path, or null.
+     */
+    Recording *Claim(const std::string &path);
+
+    [[nodiscard]] Clock::time_point Due(const Socket &socket, size_t index) const;
+
+    std::vector<CaptureRecord> records_;
+
+    std::vector<Recording> recordings_;
+
+    size_t recorded_messages_{0};
+
+    mutable std::mutex mutex_;
+
+    float speed_; // Guarded by mutex_
+
+    std::vector<std::weak_ptr<Socket> > sockets_; // Connected ones; guarded by mutex_
+
+    std::atomic<size_t> delivered_{0};
+
+    std::atomic<size_t> sent_{0};
+};
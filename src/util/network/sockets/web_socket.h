@@ -16,12 +16,22 @@ struct WebSocketImpl {
 
     virtual void send(const std::string& message) = 0;
 
+    /**
+     * Sends message as a binary frame.
+     */
+    virtual void send_binary(const std::string& message) = 0;
+
     virtual void close() = 0;
 
     std::function<void()> on_open;
 
     std::function<void(const std::string&)> on_message;
 
+    /**
+     * Binary frames; without a handler they go to on_message like text.
+     */
+    std::function<void(const std::string&)> on_binary_message;
+
     std::function<void()> on_close;
 
     std::function<void(const std::string&)> on_error;
@@ -25,7 +25,8 @@ void WebSocketDesktop::connect() {
                 if (on_open) on_open();
                 break;
             case ix::WebSocketMessageType::Message:
-                if (on_message) on_message(msg->str);
+                if (msg->binary && on_binary_message) on_binary_message(msg->str);
+                else if (on_message) on_message(msg->str);
                 break;
             case ix::WebSocketMessageType::Close:
                 if (on_close) on_close();
@@ -44,6 +45,10 @@ void WebSocketDesktop::send(const std::string &message) {
     ws.send(message);
 }
 
+void WebSocketDesktop::send_binary(const std::string &message) {
+    ws.sendBinary(message);
+}
+
 void WebSocketDesktop::close() {
     ws.stop();
 }
@@ -17,5 +17,7 @@ struct WebSocketDesktop : WebSocketImpl {
 
     void send(const std::string& message) override;
 
+    void send_binary(const std::string& message) override;
+
     void close() override;
 };
@@ -5,6 +5,10 @@
 
 WebSocketWeb::WebSocketWeb(const std::string &url_): url(url_), ws(0) {}
 
+WebSocketWeb::~WebSocketWeb() {
+    if (ws > 0) emscripten_websocket_delete(ws);
+}
+
 void WebSocketWeb::connect() {
     EmscriptenWebSocketCreateAttributes attr;
     emscripten_websocket_init_create_attributes(&attr);
@@ -23,7 +27,12 @@ void WebSocketWeb::connect() {
     emscripten_websocket_set_onmessage_callback(ws, this,
                                                 [](int, const EmscriptenWebSocketMessageEvent* e, void* user) -> EM_BOOL {
                                                     auto self = static_cast<WebSocketWeb*>(user);
-                                                    if (self->on_message) self->on_message(std::string((char*)e->data, e->numBytes));
+                                                    if (!e->isText && self->on_binary_message) {
+                                                        self->on_binary_message(std::string((char*)e->data, e->numBytes));
+                                                    } else if (self->on_message) {
+                                                        // Text frames arrive with a terminating null counted in numBytes
+                                                        self->on_message(std::string((char*)e->data, e->isText && e->numBytes > 0 ? e->numBytes - 1 : e->numBytes));
+                                                    }
                                                     return EM_TRUE;
                                                 });
 
@@ -46,6 +55,10 @@ void WebSocketWeb::send(const std::string &message) {
     emscripten_websocket_send_utf8_text(ws, message.c_str());
 }
 
+void WebSocketWeb::send_binary(const std::string &message) {
+    emscripten_websocket_send_binary(ws, const_cast<char*>(message.data()), message.size());
+}
+
 void WebSocketWeb::close() {
     emscripten_websocket_close(ws, 1000, "Closed by client");
 }
@@ -11,9 +11,16 @@ struct WebSocketWeb : WebSocketImpl {
 
     explicit WebSocketWeb(const std::string& url_);
 
+    /**
+     * Also unregisters the callbacks, which point at this.
+     */
+    ~WebSocketWeb() override;
+
     void connect() override;
 
     void send(const std::string& message) override;
 
+    void send_binary(const std::string& message) override;
+
     void close() override;
 };
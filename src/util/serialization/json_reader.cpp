@@ -0,0 +1,238 @@
+#include "json_reader.h"
+
+namespace {
+    constexpr int MAX_DEPTH = 256;
+
+    int hex_digit(const char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    void append_utf8(std::string &out, const unsigned code_point) {
+        if (code_point < 0x80) {
+            out.push_back(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else if (code_point < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+}
+
+bool JsonReader::Fail(const char *what) {
+    if (error_ == nullptr) error_ = what;
+    return false;
+}
+
+bool JsonReader::Expect(const char c) {
+    if (Failed()) return false;
+    SkipWhitespace();
+    if (pos_ >= text_.size() || text_[pos_] != c) return Fail("unexpected character");
+    pos_++;
+    previous_ = c;
+    return true;
+}
+
+bool JsonReader::Separator(const char close) {
+    if (Failed()) return false;
+    SkipWhitespace();
+    if (pos_ >= text_.size()) return Fail("unexpected end of input");
+    if (text_[pos_] == close) {
+        if (previous_ == ',') return Fail("trailing comma");
+        pos_++;
+        previous_ = 'v'; // The object or array as a whole is a complete value
+        return false;
+    }
+    if (previous_ != '{' && previous_ != '[') {
+        if (text_[pos_] != ',') return Fail("expected ',' or a closing bracket");
+        pos_++;
+        previous_ = ',';
+    }
+    return true;
+}
+
+bool JsonReader::NextKey(std::string_view &key) {
+    if (!Separator('}')) return false;
+    return ScanString(key, key_scratch_) && Expect(':');
+}
+
+bool JsonReader::NextElement() {
+    return Separator(']');
+}
+
+bool JsonReader::Literal(const std::string_view word) {
+    if (text_.compare(pos_, word.size(), word) != 0) return Fail("bad literal");
+    pos_ += word.size();
+    previous_ = 'v';
+    return true;
+}
+
+bool JsonReader::ReadNull() {
+    if (Failed()) return false;
+    SkipWhitespace();
+    if (pos_ >= text_.size() || text_[pos_] != 'n') return false;
+    return Literal("null");
+}
+
+bool JsonReader::ReadBool(bool &out) {
+    if (Failed()) return false;
+    SkipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == 't') {
+        out = true;
+        return Literal("true");
+    }
+    if (pos_ < text_.size() && text_[pos_] == 'f') {
+        out = false;
+        return Literal("false");
+    }
+    return Fail("expected a boolean");
+}
+
+bool JsonReader::ScanString(std::string_view &out, std::string &scratch) {
+    if (!Expect('"')) return false;
+    const size_t start = pos_;
+    while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') {
+        if (static_cast<unsigned char>(text_[pos_]) < 0x20) return Fail("control character in string");
+        pos_++;
+    }
+    if (pos_ >= text_.size()) return Fail("unterminated string");
+    if (text_[pos_] == '"') {
+        out = text_.substr(start, pos_ - start);
+        pos_++;
+        previous_ = 'v';
+        return true;
+    }
+
+    // Escapes: build the string in scratch from here on
+    scratch.assign(text_.substr(start, pos_ - start));
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+        const char c = text_[pos_++];
+        if (c != '\\') {
+            if (static_cast<unsigned char>(c) < 0x20) return Fail("control character in string");
+            scratch.push_back(c);
+            continue;
+        }
+        if (pos_ >= text_.size()) break;
+        switch (const char e = text_[pos_++]) {
+            case '"': scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/': scratch.push_back('/'); break;
+            case 'b': scratch.push_back('\b'); break;
+            case 'f': scratch.push_back('\f'); break;
+            case 'n': scratch.push_back('\n'); break;
+            case 'r': scratch.push_back('\r'); break;
+            case 't': scratch.push_back('\t'); break;
+            case 'u': {
+                auto read_hex4 = [this](unsigned &value) {
+                    if (pos_ + 4 > text_.size()) return false;
+                    value = 0;
+                    for (int i = 0; i < 4; i++) {
+                        const int digit = hex_digit(text_[pos_++]);
+                        if (digit < 0) return false;
+                        value = value << 4 | static_cast<unsigned>(digit);
+                    }
+                    return true;
+                };
+                unsigned code_point;
+                if (!read_hex4(code_point)) return Fail("bad \\u escape");
+                if (code_point >= 0xD800 && code_point < 0xDC00) {
+                    unsigned low;
+                    if (text_.compare(pos_, 2, "\\u") != 0) return Fail("unpaired surrogate");
+                    pos_ += 2;
+                    if (!read_hex4(low) || low < 0xDC00 || low >= 0xE000) return Fail("unpaired surrogate");
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code_point >= 0xDC00 && code_point < 0xE000) {
+                    return Fail("unpaired surrogate");
+                }
+                append_utf8(scratch, code_point);
+                break;
+            }
+            default:
+                (void) e;
+                return Fail("bad escape");
+        }
+    }
+    if (pos_ >= text_.size()) return Fail("unterminated string");
+    pos_++;
+    previous_ = 'v';
+    out = scratch;
+    return true;
+}
+
+bool JsonReader::ReadString(std::string &out) {
+    std::string_view view;
+    if (!ScanString(view, out)) return false;
+    if (view.data() != out.data()) out.assign(view);
+    return true;
+}
+
+bool JsonReader::SkipNumber() {
+    const size_t start = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-') pos_++;
+    const size_t digits = pos_;
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_];
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+            pos_++;
+        } else {
+            break;
+        }
+    }
+    if (pos_ == digits || text_[digits] < '0' || text_[digits] > '9') {
+        pos_ = start;
+        return Fail("expected a value");
+    }
+    previous_ = 'v';
+    return true;
+}
+
+bool JsonReader::SkipValue() {
+    if (Failed()) return false;
+    SkipWhitespace();
+    if (pos_ >= text_.size()) return Fail("unexpected end of input");
+    switch (text_[pos_]) {
+        case '{': {
+            if (++depth_ > MAX_DEPTH) return Fail("nested too deeply");
+            BeginObject();
+            std::string_view key;
+            while (NextKey(key)) {
+                if (!SkipValue()) return false;
+            }
+            depth_--;
+            return !Failed();
+        }
+        case '[': {
+            if (++depth_ > MAX_DEPTH) return Fail("nested too deeply");
+            BeginArray();
+            while (NextElement()) {
+                if (!SkipValue()) return false;
+            }
+            depth_--;
+            return !Failed();
+        }
+        case '"': {
+            std::string_view ignored;
+            return ScanString(ignored, key_scratch_);
+        }
+        case 't': return Literal("true");
+        case 'f': return Literal("false");
+        case 'n': return Literal("null");
+        default: return SkipNumber();
+    }
+}
+
+bool JsonReader::AtEnd() {
+    if (Failed()) return false;
+    SkipWhitespace();
+    return pos_ == text_.size();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * A pull tokenizer over JSON text for stream_decode.h: the caller asks for the value it expects
+ * next and the reader checks and consumes it, without building a DOM. The first problem puts the
+ * reader in a failed state; every later call then returns false, so callers only need to check
+ * Failed() once at the end (or bail out on the first false).
+ */
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : text_(text) {
+    }
+
+    bool BeginObject() { return Expect('{'); }
+
+    /**
+     * Reads the next key of the current object and its ':' into key, which stays valid until the
+     * next call. Returns false at the closing brace or on error.
+     */
+    bool NextKey(std::string_view &key);
+
+    bool BeginArray() { return Expect('['); }
+
+    /**
+     * True if another element of the current array follows; consumes the ',' or closing bracket.
+     */
+    bool NextElement();
+
+    /**
+     * Consumes a null and returns true if that is what comes next.
+     */
+    bool ReadNull();
+
+    bool ReadBool(bool &out);
+
+    /**
+     * Reads a string into out, reusing its capacity.
+     */
+    bool ReadString(std::string &out);
+
+    template<typename T>
+    bool ReadInteger(T &out) {
+        if (Failed()) return false;
+        SkipWhitespace();
+        const char *begin = text_.data() + pos_;
+        const char *end = text_.data() + text_.size();
+        const auto [stop, error] = std::from_chars(begin, end, out);
+        if (error != std::errc{}) return Fail("expected an integer");
+        pos_ += stop - begin;
+        previous_ = 'v';
+        if (pos_ < text_.size() && (text_[pos_] == '.' || text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            return Fail("expected an integer");
+        }
+        return true;
+    }
+
+    /**
+     * Skips one value of any type, checking it is well formed.
+     */
+    bool SkipValue();
+
+    /**
+     * True if only whitespace is left.
+     */
+    bool AtEnd();
+
+    bool Fail(const char *what);
+
+    [[nodiscard]] bool Failed() const { return error_ != nullptr; }
+
+    [[nodiscard]] const char *Error() const { return error_ != nullptr ? error_ : ""; }
+
+    [[nodiscard]] size_t Offset() const { return pos_; }
+
+private:
+    void SkipWhitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+
+    bool Expect(char c);
+
+    /**
+     * Before the next member or element: true if one follows (after consuming its ','), false
+     * after consuming the closing bracket.
+     */
+    bool Separator(char close);
+
+    bool Literal(std::string_view word);
+
+    bool SkipNumber();
+
+    /**
+     * Consumes a string. Without escapes, out views the text in place and scratch is untouched;
+     * otherwise the unescaped string is built in scratch and out views that.
+     */
+    bool ScanString(std::string_view &out, std::string &scratch);
+
+    std::string_view text_;
+
+    size_t pos_{0};
+
+    const char *error_{nullptr};
+
+    char previous_{'\0'}; // Last structural character consumed; 'v' after any complete value
+
+    int depth_{0}; // Of SkipValue's recursion
+
+    std::string key_scratch_;
+};
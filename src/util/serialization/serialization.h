@@ -39,6 +39,23 @@ T deserialize(const std::string &jsonString) {
     return j.get<T>();
 }
 
+// MessagePack counterparts, for binary frames. Same bindings, so the same fields.
+template<typename T>
+std::string serialize_msgpack(const T &obj) {
+    using namespace nlohmann;
+    const json j = obj;
+    std::string out;
+    json::to_msgpack(j, detail::output_adapter<char>(out));
+    return out;
+}
+
+template<typename T>
+T deserialize_msgpack(const std::string &bytes) {
+    using namespace nlohmann;
+    json j = json::from_msgpack(bytes);
+    return j.get<T>();
+}
+
 // Templated function that throws on error
 template<typename T>
 T deserialize_or_throw(const std::string &str) {
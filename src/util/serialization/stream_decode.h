@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "json_reader.h"
+#include "serialization.h"
+
+// Streaming decode: reads JSON straight into an existing struct with JsonReader, no DOM in between.
+// Strings, vectors and nested optionals already in the target are reused, so decoding into the
+// same object again mostly doesn't allocate. Fields not listed for a type keep their values.
+//
+// Types opt in with STREAM_DEFINE_TYPE_NON_INTRUSIVE, which also defines the usual nlohmann
+// to_json/from_json from the same field list; deserialize<T> keeps working and is the fallback
+// for anything the streaming path rejects. Like from_json, every listed field must be present.
+
+bool stream_read(JsonReader &reader, bool &value);
+
+bool stream_read(JsonReader &reader, std::string &value);
+
+template<typename T> requires std::is_integral_v<T>
+bool stream_read(JsonReader &reader, T &value);
+
+template<typename T>
+bool stream_read(JsonReader &reader, std::optional<T> &value);
+
+template<typename T>
+bool stream_read(JsonReader &reader, std::vector<T> &value);
+
+template<typename T>
+concept StreamDecodable = requires(JsonReader &reader, T &value, std::uint64_t &seen) {
+    { stream_read_field(reader, value, std::string_view{}, seen) } -> std::same_as<bool>;
+    { stream_field_count(static_cast<const T *>(nullptr)) } -> std::same_as<std::size_t>;
+};
+
+template<StreamDecodable T>
+bool stream_read(JsonReader &reader, T &value);
+
+inline bool stream_read(JsonReader &reader, bool &value) {
+    return reader.ReadBool(value);
+}
+
+inline bool stream_read(JsonReader &reader, std::string &value) {
+    return reader.ReadString(value);
+}
+
+template<typename T> requires std::is_integral_v<T>
+bool stream_read(JsonReader &reader, T &value) {
+    return reader.ReadInteger(value);
+}
+
+template<typename T>
+bool stream_read(JsonReader &reader, std::optional<T> &value) {
+    if (reader.ReadNull()) {
+        value.reset();
+        return true;
+    }
+    if (!value.has_value()) value.emplace();
+    return stream_read(reader, *value);
+}
+
+template<typename T>
+bool stream_read(JsonReader &reader, std::vector<T> &value) {
+    if (!reader.BeginArray()) return false;
+    size_t count = 0;
+    while (reader.NextElement()) {
+        if (count == value.size()) value.emplace_back();
+        if (!stream_read(reader, value[count])) return false;
+        count++;
+    }
+    if (reader.Failed()) return false;
+    value.resize(count);
+    return true;
+}
+
+template<StreamDecodable T>
+bool stream_read(JsonReader &reader, T &value) {
+    constexpr size_t fields = stream_field_count(static_cast<const T *>(nullptr));
+    static_assert(fields <= 64, "too many fields to track");
+    constexpr std::uint64_t all = fields == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << fields) - 1;
+    if (!reader.BeginObject()) return false;
+    std::uint64_t seen = 0;
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        if (!stream_read_field(reader, value, key, seen)) return false;
+    }
+    if (reader.Failed()) return false;
+    if ((seen & all) != all) return reader.Fail("missing field");
+    return true;
+}
+
+/**
+ * Decodes text into value in place. On failure value is left partly overwritten, and error (if
+ * given) says what went wrong.
+ */
+template<StreamDecodable T>
+bool stream_deserialize(const std::string_view text, T &value, std::string *error = nullptr) {
+    JsonReader reader(text);
+    if (stream_read(reader, value) && reader.AtEnd()) return true;
+    if (error != nullptr) {
+        *error = reader.Failed() ? reader.Error() : "trailing characters";
+        *error += " at offset " + std::to_string(reader.Offset());
+    }
+    return false;
+}
+
+#define STREAM_DECODE_FIELD(field) \
+    if (key == #field) { \
+        seen |= bit; \
+        return stream_read(reader, value.field); \
+    } \
+    bit <<= 1;
+
+#define STREAM_DECODE_NAME(field) #field,
+
+/**
+ * Generates the field table stream_read uses for Type: one key comparison per listed field, in
+ * order. Unknown keys are skipped.
+ */
+#define STREAM_DECODE_FIELDS(Type, ...) \
+    inline bool stream_read_field(JsonReader &reader, Type &value, std::string_view key, std::uint64_t &seen) { \
+        std::uint64_t bit = 1; \
+        NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(STREAM_DECODE_FIELD, __VA_ARGS__)) \
+        (void) bit; \
+        return reader.SkipValue(); \
+    } \
+    constexpr std::size_t stream_field_count(const Type *) { \
+        constexpr const char *names[] = {NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(STREAM_DECODE_NAME, __VA_ARGS__))}; \
+        return std::size(names); \
+    }
+
+/**
+ * NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE plus STREAM_DECODE_FIELDS over the same fields.
+ */
+#define STREAM_DEFINE_TYPE_NON_INTRUSIVE(Type, ...) \
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Type, __VA_ARGS__) \
+    STREAM_DECODE_FIELDS(Type, __VA_ARGS__)
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Collects duration samples (in milliseconds) and reports percentiles. Reserve up front so
+ * recording stays allocation-free in hot loops.
+ */
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(const size_t reserve = 0) {
+        samples_.reserve(reserve);
+    }
+
+    /**
+     * Keeps only the most recent capacity samples, for live stats that run indefinitely.
+     */
+    static LatencyRecorder Window(const size_t capacity) {
+        LatencyRecorder recorder(capacity);
+        recorder.window_ = capacity;
+        return recorder;
+    }
+
+    void Record(const double ms) {
+        if (window_ > 0 && samples_.size() == window_) {
+            samples_[next_] = ms;
+            next_ = (next_ + 1) % window_;
+        } else {
+            samples_.push_back(ms);
+        }
+        sorted_ = false;
+    }
+
+    template<typename Duration>
+    void Record(const Duration duration) {
+        Record(std::chrono::duration<double, std::milli>(duration).count());
+    }
+
+    void Clear() {
+        samples_.clear();
+        next_ = 0;
+        sorted_ = true;
+    }
+
+    [[nodiscard]] size_t Count() const { return samples_.size(); }
+
+    /**
+     * p in [0, 100]. Returns 0 with no samples.
+     */
+    double Percentile(const double p) {
+        if (samples_.empty()) return 0;
+        // A window has to keep its samples in arrival order, so it sorts a copy
+        auto &sorted = window_ > 0 ? scratch_ : samples_;
+        if (!sorted_) {
+            if (window_ > 0) scratch_.assign(samples_.begin(), samples_.end());
+            std::sort(sorted.begin(), sorted.end());
+            sorted_ = true;
+        }
+        const auto rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    [[nodiscard]] double Mean() const {
+        if (samples_.empty()) return 0;
+        double sum = 0;
+        for (const double s: samples_) sum += s;
+        return sum / static_cast<double>(samples_.size());
+    }
+
+    [[nodiscard]] double Total() const {
+        double sum = 0;
+        for (const double s: samples_) sum += s;
+        return sum;
+    }
+
+private:
+    std::vector<double> samples_;
+
+    std::vector<double> scratch_;
+
+    size_t window_{0};
+
+    size_t next_{0}; // Oldest sample once a window is full
+
+    bool sorted_{true};
+};
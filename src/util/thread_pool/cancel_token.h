@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+/**
+ * Shared cancellation flag plus an optional deadline. Copies refer to the same flag, so the
+ * owner keeps one and hands copies to the tasks doing the work.
+ */
+class CancelToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancelToken() : cancelled_(std::make_shared<std::atomic<bool> >(false)) {
+    }
+
+    explicit CancelToken(const Clock::time_point deadline) : CancelToken() {
+        deadline_ = deadline;
+    }
+
+    void Cancel() const { cancelled_->store(true, std::memory_order_relaxed); }
+
+    /**
+     * Cancelled explicitly or past the deadline. Reads the clock, so poll it every few thousand
+     * iterations rather than every one.
+     */
+    [[nodiscard]] bool Expired() const {
+        return cancelled_->load(std::memory_order_relaxed) || Clock::now() >= deadline_;
+    }
+
+    [[nodiscard]] bool Cancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool> > cancelled_;
+
+    Clock::time_point deadline_{Clock::time_point::max()};
+};
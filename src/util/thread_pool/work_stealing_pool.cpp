@@ -0,0 +1,107 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+#ifndef PTHREAD_POOL_SIZE
+#define PTHREAD_POOL_SIZE 5
+#endif
+
+WorkStealingPool::WorkStealingPool(size_t thread_count) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        threads_.emplace_back(&WorkStealingPool::Run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread: threads_) {
+        thread.join();
+    }
+}
+
+size_t WorkStealingPool::DefaultThreadCount() {
+#ifdef __EMSCRIPTEN__
+    return std::max(PTHREAD_POOL_SIZE - 2, 1);
+#else
+    const size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+#endif
+}
+
+void WorkStealingPool::Submit(Task task) {
+    // Counted before it is queued so pending_ never drops below the number of queued tasks
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    auto &worker = *workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    {
+        // Taken so a worker between its predicate check and wait() can't miss the notify
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+void WorkStealingPool::SubmitBatch(std::vector<Task> &tasks) {
+    if (tasks.empty()) return;
+    pending_.fetch_add(tasks.size(), std::memory_order_acq_rel);
+    const size_t first = next_worker_.fetch_add(tasks.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < tasks.size(); i++) {
+        auto &worker = *workers_[(first + i) % workers_.size()];
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back(std::move(tasks[i]));
+    }
+    tasks.clear();
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+}
+
+bool WorkStealingPool::TryTake(const size_t self, Task &task) {
+    {
+        auto &own = *workers_[self];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < workers_.size(); offset++) {
+        auto &victim = *workers_[(self + offset) % workers_.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::Run(const size_t self) {
+    Task task;
+    while (true) {
+        if (TryTake(self, task)) {
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            task(self);
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && pending_.load(std::memory_order_acquire) == 0) return;
+    }
+}
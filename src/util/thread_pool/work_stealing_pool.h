@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads, each with its own task deque. A worker takes its newest task
+ * first and, when it runs dry, steals the oldest task of another worker, so a batch of uneven
+ * tasks spreads itself over the pool without a shared queue everyone contends on.
+ *
+ * Tasks receive the index of the worker running them, which callers use to pick per-thread
+ * scratch space without locking.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t worker)>;
+
+    explicit WorkStealingPool(size_t thread_count = DefaultThreadCount());
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * Finishes queued tasks, then joins.
+     */
+    ~WorkStealingPool();
+
+    /**
+     * All cores but the one running the main loop. On Emscripten, what the prebuilt pthread pool
+     * allows after the game message decoder and one spare worker (anything beyond the pool
+     * waits for the browser to spawn a worker, which it only does after we yield).
+     */
+    static size_t DefaultThreadCount();
+
+    [[nodiscard]] size_t ThreadCount() const { return threads_.size(); }
+
+    void Submit(Task task);
+
+    /**
+     * Spreads the tasks across workers round-robin and wakes them once.
+     */
+    void SubmitBatch(std::vector<Task> &tasks);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Run(size_t self);
+
+    bool TryTake(size_t self, Task &task);
+
+    std::vector<std::unique_ptr<Worker> > workers_;
+
+    std::vector<std::thread> threads_;
+
+    std::mutex sleep_mutex_;
+
+    std::condition_variable wake_;
+
+    std::atomic<size_t> pending_{0};
+
+    std::atomic<size_t> next_worker_{0};
+
+    bool stopping_{false};
+};